@@ -0,0 +1,539 @@
+//
+//  benchmark.cpp
+//  SnakeGL
+//
+//  Created by Keegan Bilodeau on 10/19/26.
+//  Copyright © 2026 Keegan Bilodeau. All rights reserved.
+//
+
+#include "benchmark.hpp"
+
+#include <math.h>
+#include <chrono>
+#include <memory>
+#include <string.h>
+#include <algorithm>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "board.hpp"
+#include "bot.hpp"
+#include "observation.hpp"
+#include "snapshot.hpp"
+#include "particles.hpp"
+#include "server.hpp"
+#include "netclient.hpp"
+
+// Seconds elapsed since the given time point
+static double secondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Creates a hidden window so that GL benchmarks have a context, returns nullptr on failure
+static GLFWwindow* createHiddenContext()
+{
+    glfwInit();
+    
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GLFW_TRUE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    
+    GLFWwindow* window = glfwCreateWindow(64, 64, "SnakeGL benchmark", nullptr, nullptr);
+    if (window == nullptr)
+    {
+        puts("Failed to create benchmark context!");
+        glfwTerminate();
+        return nullptr;
+    }
+    glfwMakeContextCurrent(window);
+    
+    if (!gladLoadGLLoader((GLADloadproc) glfwGetProcAddress))
+    {
+        puts("Failed to initialize GLAD!");
+        glfwTerminate();
+        return nullptr;
+    }
+    
+    return window;
+}
+
+// Fills a list of boards with snakes that have played for a while, so they are not all identical
+static void playBoards(std::vector<Board> &boards, int count, int size)
+{
+    BotController bots;
+    for (int i = 0; i < count; i++)
+    {
+        boards.emplace_back(size, size, i + 1);
+        Board &board = boards.back();
+        
+        // The snake goes down first so that food can not block its spot
+        int snake = board.addSnake(size / 2, size / 2, NORTH, 4);
+        board.setFoodTarget(2);
+        for (int tick = 0; tick < 20 + i % 100; tick++)
+        {
+            board.setDirection(snake, bots.decide(board, snake));
+            board.tick();
+        }
+    }
+}
+
+bool runBenchmark(const char* name)
+{
+    if (strcmp(name, "bot") == 0)
+        benchmarkBots();
+    else if (strcmp(name, "obs") == 0)
+        benchmarkObservations();
+    else if (strcmp(name, "snapshot") == 0)
+        benchmarkSnapshots();
+    else if (strcmp(name, "particles") == 0)
+        benchmarkParticles();
+    else if (strcmp(name, "net") == 0)
+        benchmarkNetwork();
+    else
+    {
+        printf("Unknown benchmark '%s', available: bot, obs, snapshot, particles, net\n", name);
+        return false;
+    }
+    
+    return true;
+}
+
+void benchmarkBots()
+{
+    printf("%8s %8s %12s %12s %10s\n", "board", "bots", "decisions/s", "ms/tick", "cache hit");
+    
+    for (int size = 32; size <= 512; size *= 2)
+    {
+        // One snake for every 64 cells, food for every other snake
+        int snakeCount = size * size / 64;
+        Board board(size, size, 1234, snakeCount, snakeCount / 2);
+        BotController bots;
+        
+        board.setFoodTarget(snakeCount / 2);
+        
+        uint32_t seed = 99;
+        auto spawn = [&]()
+        {
+            // Keeps trying random spots until a snake fits
+            for (int attempt = 0; attempt < 32; attempt++)
+            {
+                seed = seed * 1664525u + 1013904223u;
+                int snake = board.addSnake((seed >> 8) % size, (seed >> 20) % size, (Direction) (seed >> 30), 4);
+                if (snake >= 0)
+                {
+                    bots.addBot(snake);
+                    return;
+                }
+            }
+        };
+        
+        for (int i = 0; i < snakeCount; i++)
+            spawn();
+        
+        // Warms the paths up before measuring
+        for (int tick = 0; tick < 10; tick++)
+        {
+            bots.update(board);
+            board.tick();
+        }
+        
+        uint64_t decisions = bots.decisions, hits = bots.cacheHits;
+        double botSeconds = 0.0;
+        int ticks = 0;
+        
+        while (botSeconds < 1.0 && ticks < 1000)
+        {
+            auto start = std::chrono::steady_clock::now();
+            bots.update(board);
+            botSeconds += secondsSince(start);
+            
+            board.tick();
+            ticks++;
+            
+            // Dead snakes are replaced so the population stays constant
+            int alive = 0;
+            for (int i = 0; i < board.getSnakeCount(); i++)
+                alive += board.getSnake(i).alive;
+            for (int i = alive; i < snakeCount; i++)
+                spawn();
+        }
+        
+        decisions = bots.decisions - decisions;
+        hits = bots.cacheHits - hits;
+        
+        printf("%4dx%-4d %8d %12.0f %12.3f %9.1f%%\n", size, size, snakeCount, decisions / botSeconds, botSeconds * 1000.0 / ticks, 100.0 * hits / decisions);
+    }
+}
+
+void benchmarkObservations()
+{
+    GLFWwindow* window = createHiddenContext();
+    if (window == nullptr)
+        return;
+    
+    const int TILE_SIZE = 84, BOARD_SIZE = 20;
+    
+    printf("%8s %14s %14s %10s\n", "boards", "gpu boards/s", "cpu boards/s", "mismatch");
+    
+    for (int count = 64; count <= 4096; count *= 4)
+    {
+        std::vector<Board> boards;
+        playBoards(boards, count, BOARD_SIZE);
+        
+        std::vector<const Board*> batch;
+        for (const Board &board : boards)
+            batch.push_back(&board);
+        
+        // Each renderer has its own atlas sized for the batch
+        ObservationRenderer renderer(TILE_SIZE);
+        if (!renderer.initGPU(std::min(count, 1024)))
+            break;
+        
+        std::vector<uint8_t> gpuPixels, cpuPixels;
+        
+        // First runs are warmups that also allocate the output buffers
+        renderer.renderGPU(batch, gpuPixels);
+        renderer.renderCPU(batch, cpuPixels);
+        
+        int runs = 0;
+        auto start = std::chrono::steady_clock::now();
+        while (secondsSince(start) < 1.0)
+        {
+            renderer.renderGPU(batch, gpuPixels);
+            runs++;
+        }
+        double gpuRate = (double) count * runs / secondsSince(start);
+        
+        runs = 0;
+        start = std::chrono::steady_clock::now();
+        while (secondsSince(start) < 1.0)
+        {
+            renderer.renderCPU(batch, cpuPixels);
+            runs++;
+        }
+        double cpuRate = (double) count * runs / secondsSince(start);
+        
+        // Both paths should produce the same pixels, apart from rounding at cell edges
+        size_t mismatched = 0;
+        for (size_t i = 0; i < gpuPixels.size(); i += 4)
+            mismatched += memcmp(&gpuPixels[i], &cpuPixels[i], 4) != 0;
+        
+        printf("%8d %14.0f %14.0f %9.3f%%\n", count, gpuRate, cpuRate, 100.0 * mismatched / (gpuPixels.size() / 4));
+    }
+    
+    glfwDestroyWindow(window);
+    glfwTerminate();
+}
+
+void benchmarkSnapshots()
+{
+    printf("%8s %10s %12s %12s %12s %10s\n", "board", "state KB", "clones/s", "delta/s", "full/s", "mismatch");
+    
+    for (int size = 32; size <= 1024; size *= 2)
+    {
+        // A few bot snakes so that ticks write to a handful of pages spread over the board
+        int snakeCount = std::max(1, size / 64);
+        Board board(size, size, 4321, snakeCount, snakeCount);
+        BotController bots;
+        for (int i = 0; i < snakeCount; i++)
+        {
+            int snake = board.addSnake((i * 37) % size, (i * 11) % (size - 4) + 3, NORTH, 4);
+            if (snake >= 0)
+                bots.addBot(snake);
+        }
+        board.setFoodTarget(snakeCount);
+        for (int tick = 0; tick < 20; tick++)
+        {
+            bots.update(board);
+            board.tick();
+        }
+        
+        BoardSnapshot base, other;
+        
+        // Clones are a single copy of the whole state
+        int runs = 0;
+        auto start = std::chrono::steady_clock::now();
+        while (secondsSince(start) < 0.5)
+        {
+            board.snapshot(other);
+            runs++;
+        }
+        double cloneRate = runs / secondsSince(start);
+        
+        // Delta restores undo one tick, only the restore is timed
+        board.snapshot(base);
+        double restoreSeconds = 0.0;
+        size_t mismatched = 0;
+        runs = 0;
+        while (restoreSeconds < 0.5 && runs < 4000)
+        {
+            bots.update(board);
+            board.tick();
+            
+            auto restoreStart = std::chrono::steady_clock::now();
+            board.restore(base);
+            restoreSeconds += secondsSince(restoreStart);
+            runs++;
+            
+            // The board has to end up exactly where the snapshot was taken
+            if (runs % 64 == 1)
+                mismatched += memcmp(board.getState(), base.data.data(), board.getStateSize()) != 0;
+        }
+        double deltaRate = runs / restoreSeconds;
+        
+        // Alternating between two snapshots means every restore copies the whole state
+        runs = 0;
+        start = std::chrono::steady_clock::now();
+        while (secondsSince(start) < 0.5)
+        {
+            board.restore(runs % 2 ? base : other);
+            runs++;
+        }
+        double fullRate = runs / secondsSince(start);
+        
+        printf("%4dx%-4d %10.1f %12.0f %12.0f %12.0f %10zu\n", size, size, board.getStateSize() / 1024.0, cloneRate, deltaRate, fullRate, mismatched);
+    }
+    
+    // Bulk checkpoints of many small boards, as a search would write them
+    const int FILE_BOARDS = 4096, FILE_BOARD_SIZE = 20;
+    const char* path = "snapshot_benchmark.snkc";
+    
+    std::vector<Board> boards;
+    playBoards(boards, FILE_BOARDS, FILE_BOARD_SIZE);
+    
+    std::vector<const Board*> list;
+    for (const Board &board : boards)
+        list.push_back(&board);
+    std::vector<GameState> games(FILE_BOARDS, GameState());
+    
+    auto start = std::chrono::steady_clock::now();
+    if (!CheckpointFile::save(path, games, list))
+        return;
+    double saveSeconds = secondsSince(start);
+    
+    // Opening maps the file, every board is then copied out of the mapping
+    start = std::chrono::steady_clock::now();
+    CheckpointFile file;
+    Board loaded(FILE_BOARD_SIZE, FILE_BOARD_SIZE);
+    size_t mismatched = 0;
+    if (file.open(path))
+    {
+        for (size_t i = 0; i < file.getCount(); i++)
+        {
+            if (!file.loadBoard(i, loaded))
+                mismatched++;
+            else if (i % 64 == 0)
+                mismatched += memcmp(loaded.getState(), boards[i].getState(), loaded.getStateSize()) != 0;
+        }
+    }
+    double loadSeconds = secondsSince(start);
+    file.close();
+    remove(path);
+    
+    printf("\ncheckpoint file: %d boards of %dx%d, %.0f boards/s saved, %.0f boards/s loaded, %zu mismatched\n", FILE_BOARDS, FILE_BOARD_SIZE, FILE_BOARD_SIZE, FILE_BOARDS / saveSeconds, FILE_BOARDS / loadSeconds, mismatched);
+}
+
+// Runs frames of a particle system kept at a steady population, returns the average milliseconds per frame
+// Each frame emits what dies, so the pool stays at count while particles keep being retired and compacted
+static double runParticleFrames(ParticleSystem &system, size_t count, bool render, GLStateCache &cache)
+{
+    // emit spreads lifetimes over 75% to 100% of the given one, this averages out to one second
+    const float FRAME_TIME = 1.0f / 60.0f, LIFETIME = 1.0f / 0.875f;
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.0f, 3.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), 1.0f, 0.1f, 100.0f);
+    
+    // Fills the pool with particles of spread out ages, for longer than the longest lifetime
+    for (int frame = 0; frame < 90; frame++)
+    {
+        system.emit(glm::vec3(0.0f), (int) (count / 60), glm::vec3(1.0f, 0.5f, 0.2f), 1.0f, LIFETIME);
+        system.update(FRAME_TIME);
+        if (render)
+            system.render(cache, view, projection);
+    }
+    if (render)
+        glFinish();
+    
+    int frames = 0;
+    auto start = std::chrono::steady_clock::now();
+    while (secondsSince(start) < 1.0)
+    {
+        system.emit(glm::vec3(0.0f), (int) (count / 60), glm::vec3(1.0f, 0.5f, 0.2f), 1.0f, LIFETIME);
+        system.update(FRAME_TIME);
+        if (render)
+        {
+            system.render(cache, view, projection);
+            glFinish();
+        }
+        frames++;
+    }
+    
+    return secondsSince(start) * 1000.0 / frames;
+}
+
+void benchmarkParticles()
+{
+    const size_t COUNTS[] = {10000, 50000, 100000, 250000, 500000, 1000000};
+    GLStateCache cache;
+    
+    printf("%10s %10s %14s\n", "particles", "live", "cpu update ms");
+    for (size_t count : COUNTS)
+    {
+        ParticleSystem system(count * 2);
+        double milliseconds = runParticleFrames(system, count, false, cache);
+        printf("%10zu %10zu %14.3f\n", count, system.getCount(), milliseconds);
+    }
+    
+    // Whole frames including the upload or the transform feedback pass, waited on with glFinish
+    GLFWwindow* window = createHiddenContext();
+    if (window == nullptr)
+        return;
+    
+    printf("\n%10s %14s %14s\n", "particles", "cpu frame ms", "gpu frame ms");
+    for (size_t count : COUNTS)
+    {
+        ParticleSystem system(count * 2);
+        if (!system.initGPU())
+            break;
+        cache.invalidate();
+        
+        double cpuMilliseconds = runParticleFrames(system, count, true, cache);
+        double gpuMilliseconds = system.setMode(PARTICLES_GPU) ? runParticleFrames(system, count, true, cache) : 0.0;
+        printf("%10zu %14.3f %14.3f\n", count, cpuMilliseconds, gpuMilliseconds);
+    }
+    
+    glfwDestroyWindow(window);
+    glfwTerminate();
+}
+
+// Picks a load test client's next move from its newest snapshot, heading for the closest food it can see
+static Direction chooseDirection(const NetClient &client)
+{
+    const NetSnakeState &snake = client.getSnake();
+    const NetView &view = client.getView();
+    const int STEP_X[4] = {0, 1, 0, -1}, STEP_Y[4] = {1, 0, -1, 0};
+    
+    int foodX = -1, foodY = -1, closest = INT32_MAX;
+    for (int y = view.y; y < view.y + view.height; y++)
+    {
+        for (int x = view.x; x < view.x + view.width; x++)
+        {
+            int distance = abs(x - snake.headX) + abs(y - snake.headY);
+            if (view.getCell(x, y) == CELL_FOOD && distance < closest)
+            {
+                foodX = x;
+                foodY = y;
+                closest = distance;
+            }
+        }
+    }
+    
+    // Any free cell beats a wall, getting closer to food beats keeping straight
+    Direction choice = snake.direction;
+    int best = INT32_MIN;
+    for (int d = 0; d < 4; d++)
+    {
+        int x = snake.headX + STEP_X[d], y = snake.headY + STEP_Y[d];
+        uint8_t cell = view.getCell(x, y);
+        if (d == oppositeDirection(snake.direction) || x < 0 || y < 0 || x >= client.getBoardWidth() || y >= client.getBoardHeight() || (cell != CELL_EMPTY && cell != CELL_FOOD))
+            continue;
+        
+        int score = foodX >= 0 ? -(abs(x - foodX) + abs(y - foodY)) * 2 : 0;
+        score += d == snake.direction;
+        if (score > best)
+        {
+            best = score;
+            choice = (Direction) d;
+        }
+    }
+    
+    return choice;
+}
+
+void benchmarkNetwork()
+{
+    // Player counts to load the server with, the last run drops a tenth of the snapshots on the way in
+    const int PLAYERS[] = {1, 8, 32, 128, 128};
+    const float LOSS[] = {0.0f, 0.0f, 0.0f, 0.0f, 0.1f};
+    const int WARMUP_TICKS = 20, MEASURED_TICKS = 300;
+    
+    printf("%8s %8s %6s %10s %10s %12s %10s %8s %10s\n", "players", "arena", "loss", "ms/tick", "max ms", "down B/s", "up B/s", "full", "mismatch");
+    
+    for (size_t run = 0; run < sizeof(PLAYERS) / sizeof(PLAYERS[0]); run++)
+    {
+        // The arena grows with the players so that crowding stays about the same
+        int players = PLAYERS[run], size = std::max(32, (int) sqrt(players * 256.0));
+        GameServer server(size, size, players);
+        if (!server.start(0))
+            return;
+        
+        std::vector<std::unique_ptr<NetClient>> clients;
+        for (int i = 0; i < players; i++)
+        {
+            clients.emplace_back(new NetClient());
+            clients.back()->simulatedLoss = LOSS[run];
+            if (!clients.back()->connect(loopbackAddress(server.getPort())))
+                return;
+        }
+        
+        // Ticks back to back instead of waiting for the tick time, every client reads its snapshot and
+        // answers before the next tick, as if the network had no latency
+        auto step = [&]()
+        {
+            server.tick();
+            for (std::unique_ptr<NetClient> &client : clients)
+            {
+                client->update();
+                if (!client->isConnected())
+                    continue;
+                
+                if (client->getSnake().alive)
+                    client->sendInput(chooseDirection(*client));
+                else
+                    client->sendInput();
+            }
+        };
+        
+        // Waits for every connection before measuring, lost welcomes are only retried every so often
+        auto connected = [&]()
+        {
+            return std::all_of(clients.begin(), clients.end(), [](const std::unique_ptr<NetClient> &client) { return client->isConnected(); });
+        };
+        auto start = std::chrono::steady_clock::now();
+        for (int tick = 0; tick < WARMUP_TICKS || (!connected() && secondsSince(start) < 5.0); tick++)
+            step();
+        
+        server.resetStats();
+        for (std::unique_ptr<NetClient> &client : clients)
+            client->bytesSent = 0;
+        for (int tick = 0; tick < MEASURED_TICKS; tick++)
+            step();
+        
+        // Every client that got the last snapshot should see exactly the server's cells in its window
+        const Board &board = server.getBoard();
+        size_t compared = 0, mismatched = 0;
+        for (std::unique_ptr<NetClient> &client : clients)
+        {
+            const NetView &view = client->getView();
+            if (view.tick != board.getTick())
+                continue;
+            
+            for (int y = view.y; y < view.y + view.height; y++)
+                for (int x = view.x; x < view.x + view.width; x++)
+                    mismatched += view.getCell(x, y) != board.getCell(y * board.getWidth() + x);
+            compared += view.width * view.height;
+        }
+        
+        // Traffic is per client and second of game time at the server's tick rate
+        uint64_t upload = 0;
+        for (std::unique_ptr<NetClient> &client : clients)
+            upload += client->bytesSent;
+        double seconds = MEASURED_TICKS * server.getTickTime();
+        
+        printf("%8d %4dx%-3d %5.0f%% %10.3f %10.3f %12.0f %10.0f %7.1f%% %9.3f%%\n", players, size, size, LOSS[run] * 100.0f, server.tickSeconds * 1000.0 / server.ticks, server.maxTickSeconds * 1000.0, server.bytesSent / seconds / players, upload / seconds / players, 100.0 * server.fullSnapshots / std::max((uint64_t) 1, server.snapshotsSent), compared ? 100.0 * mismatched / compared : 100.0);
+    }
+}
@@ -0,0 +1,32 @@
+//
+//  benchmark.hpp
+//  SnakeGL
+//
+//  Created by Keegan Bilodeau on 10/19/26.
+//  Copyright © 2026 Keegan Bilodeau. All rights reserved.
+//
+
+#ifndef benchmark_hpp
+#define benchmark_hpp
+
+#include <stdio.h>
+
+// Runs the named benchmark (SnakeGL --bench <name>), returns false if there is no benchmark with that name
+bool runBenchmark(const char* name);
+
+// Bot decisions per second for growing board sizes and snake counts
+void benchmarkBots();
+
+// Observation images per second from the instanced GL atlas and the CPU rasterizer
+void benchmarkObservations();
+
+// Board clones and restores per second, and checkpoint file save and load throughput
+void benchmarkSnapshots();
+
+// Particle update cost on the CPU and, with a GL context, frame cost of CPU and GPU simulation
+void benchmarkParticles();
+
+// Server tick time and bandwidth per client for growing numbers of bot clients over loopback
+void benchmarkNetwork();
+
+#endif /* benchmark_hpp */
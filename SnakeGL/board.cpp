@@ -0,0 +1,546 @@
+//
+//  board.cpp
+//  SnakeGL
+//
+//  Created by Keegan Bilodeau on 10/19/26.
+//  Copyright © 2026 Keegan Bilodeau. All rights reserved.
+//
+
+#include "board.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <string.h>
+#include <type_traits>
+
+// The flat state is copied with memcpy, so everything stored in it has to allow that
+static_assert(std::is_trivially_copyable<BoardHeader>::value && std::is_trivially_copyable<Snake>::value, "Board state must be trivially copyable");
+
+// Source of snapshot ids, zero is never handed out
+static std::atomic<uint64_t> nextSnapshotId(1);
+
+// Rounds a byte count up to whole words
+static size_t alignWord(size_t bytes)
+{
+    return (bytes + 7) & ~(size_t) 7;
+}
+
+Board::Board(int width, int height, unsigned int seed, int maxSnakes, int maxFood) : mBaseSnapshot(0)
+{
+    BoardHeader initial = {};
+    initial.version = BOARD_STATE_VERSION;
+    initial.width = width;
+    initial.height = height;
+    // Rows are padded to whole words so that row operations never straddle two rows
+    initial.rowWords = (width + 63) / 64;
+    initial.snakeCapacity = maxSnakes;
+    initial.foodCapacity = maxFood;
+    initial.foodTarget = std::min(1, maxFood);
+    // Xorshift has a zero fixed point, so the seed can never be zero
+    initial.seed = seed ? seed : 1;
+    
+    // Everything after the header starts out zeroed, which leaves every cell empty
+    mState.assign(alignWord(sizeof(BoardHeader)) / sizeof(uint64_t), 0);
+    header() = initial;
+    layout();
+}
+
+int Board::addSnake(int x, int y, Direction direction, int length)
+{
+    // Snakes need at least a head and a tail segment for the cell links to work
+    if (x < 0 || y < 0 || x >= mWidth || y >= mHeight || length < 2)
+        return -1;
+    
+    // Reuses the first dead slot, or takes a new one while there is room
+    BoardHeader &state = header();
+    int slot = 0;
+    while (slot < state.snakeCount && snakes()[slot].alive)
+        slot++;
+    if (slot >= state.snakeCapacity)
+        return -1;
+    
+    // Walks from the head towards the tail to make sure the whole body fits on empty cells
+    int head = y * mWidth + x, cell = head;
+    for (int i = 1; i < length; i++)
+    {
+        cell = getNeighbor(cell, oppositeDirection(direction));
+        if (cell < 0 || cells()[cell] != CELL_EMPTY)
+            return -1;
+    }
+    if (cells()[head] != CELL_EMPTY)
+        return -1;
+    
+    // Lays the body down, every segment links towards the head
+    setCell(head, CELL_HEAD);
+    cell = head;
+    for (int i = 1; i < length; i++)
+    {
+        cell = getNeighbor(cell, oppositeDirection(direction));
+        setCell(cell, CELL_BODY + direction);
+    }
+    
+    snakes()[slot] = Snake{head, cell, length, 0, direction, direction, true, 0};
+    markDirty(&snakes()[slot], sizeof(Snake));
+    
+    if (slot == state.snakeCount)
+    {
+        state.snakeCount++;
+        markDirty(&state, sizeof(BoardHeader));
+    }
+    
+    return slot;
+}
+
+void Board::setDirection(int snake, Direction direction)
+{
+    Snake &target = snakes()[snake];
+    
+    // A snake longer than one cell can not reverse into its own neck
+    if (target.length > 1 && direction == oppositeDirection(target.direction))
+        return;
+    
+    target.nextDirection = direction;
+    markDirty(&target, sizeof(Snake));
+}
+
+void Board::removeSnake(int snake)
+{
+    Snake &target = snakes()[snake];
+    if (target.alive)
+        killSnake(target);
+}
+
+void Board::tick()
+{
+    BoardHeader &state = header();
+    Snake* list = snakes();
+    
+    // First pass moves the tails so that heads may follow directly behind a tail
+    for (int i = 0; i < state.snakeCount; i++)
+    {
+        Snake &snake = list[i];
+        if (!snake.alive)
+            continue;
+        
+        snake.direction = snake.nextDirection;
+        markDirty(&snake, sizeof(Snake));
+        
+        // Eating this tick means the tail has to stay where it is
+        int target = getNeighbor(snake.head, snake.direction);
+        if (target >= 0 && cells()[target] == CELL_FOOD)
+            snake.growth++;
+        
+        if (snake.growth > 0)
+        {
+            snake.growth--;
+            snake.length++;
+            continue;
+        }
+        
+        // The tail cell stores the direction to the segment that becomes the new tail
+        int tail = snake.tail;
+        snake.tail = getNeighbor(tail, (Direction) (cells()[tail] - CELL_BODY));
+        setCell(tail, CELL_EMPTY);
+    }
+    
+    // Second pass moves the heads, anything running into a wall or an occupied cell dies
+    for (int i = 0; i < state.snakeCount; i++)
+    {
+        Snake &snake = list[i];
+        if (!snake.alive)
+            continue;
+        
+        int target = getNeighbor(snake.head, snake.direction);
+        if (target < 0 || isOccupied(target))
+        {
+            killSnake(snake);
+            continue;
+        }
+        
+        if (cells()[target] == CELL_FOOD)
+        {
+            removeFood(target);
+            snake.score++;
+        }
+        
+        // The old head becomes a body segment linking to the new head
+        setCell(snake.head, CELL_BODY + snake.direction);
+        setCell(target, CELL_HEAD);
+        snake.head = target;
+    }
+    
+    // Tops the food back up to the target amount
+    while (state.foodCount < state.foodTarget && spawnFood());
+    
+    state.tick++;
+    markDirty(&state, sizeof(BoardHeader));
+}
+
+bool Board::spawnFood()
+{
+    BoardHeader &state = header();
+    if (state.foodCount >= state.foodCapacity)
+        return false;
+    
+    int cellCount = mWidth * mHeight, found = -1;
+    
+    // Random probing finds an empty cell quickly unless the board is nearly full
+    for (int attempt = 0; attempt < 64 && found < 0; attempt++)
+    {
+        int cell = random() % cellCount;
+        if (cells()[cell] == CELL_EMPTY)
+            found = cell;
+    }
+    
+    // Falls back to a linear scan from a random starting point
+    if (found < 0)
+    {
+        int start = random() % cellCount;
+        for (int i = 0; i < cellCount && found < 0; i++)
+        {
+            int cell = (start + i) % cellCount;
+            if (cells()[cell] == CELL_EMPTY)
+                found = cell;
+        }
+    }
+    
+    if (found < 0)
+        return false;
+    
+    setCell(found, CELL_FOOD);
+    food()[state.foodCount] = found;
+    markDirty(&food()[state.foodCount], sizeof(int32_t));
+    state.foodCount++;
+    markDirty(&state, sizeof(BoardHeader));
+    
+    return true;
+}
+
+void Board::setFoodTarget(int count)
+{
+    BoardHeader &state = header();
+    state.foodTarget = std::min(count, state.foodCapacity);
+    markDirty(&state, sizeof(BoardHeader));
+    
+    while (state.foodCount < state.foodTarget && spawnFood());
+}
+
+int Board::getWidth() const
+{
+    return mWidth;
+}
+
+int Board::getHeight() const
+{
+    return mHeight;
+}
+
+uint64_t Board::getTick() const
+{
+    return header().tick;
+}
+
+uint8_t Board::getCell(int cell) const
+{
+    return cells()[cell];
+}
+
+bool Board::isOccupied(int cell) const
+{
+    return cells()[cell] >= CELL_BODY;
+}
+
+bool Board::isFood(int cell) const
+{
+    return cells()[cell] == CELL_FOOD;
+}
+
+int Board::getNeighbor(int cell, Direction direction) const
+{
+    int x = cell % mWidth, y = cell / mWidth;
+    
+    // Steps one cell and rejects anything that falls off the edge
+    switch (direction)
+    {
+        case NORTH:
+            return y + 1 < mHeight ? cell + mWidth : -1;
+        case SOUTH:
+            return y > 0 ? cell - mWidth : -1;
+        case EAST:
+            return x + 1 < mWidth ? cell + 1 : -1;
+        case WEST:
+            return x > 0 ? cell - 1 : -1;
+    }
+    
+    return -1;
+}
+
+const uint64_t* Board::getOccupancy() const
+{
+    return occupancy();
+}
+
+int Board::getRowWords() const
+{
+    return mRowWords;
+}
+
+int Board::getSnakeCount() const
+{
+    return header().snakeCount;
+}
+
+const Snake &Board::getSnake(int snake) const
+{
+    return snakes()[snake];
+}
+
+int Board::getFoodCount() const
+{
+    return header().foodCount;
+}
+
+const int32_t* Board::getFood() const
+{
+    return food();
+}
+
+const void* Board::getState() const
+{
+    return mState.data();
+}
+
+size_t Board::getStateSize() const
+{
+    return mState.size() * sizeof(uint64_t);
+}
+
+bool Board::loadState(const void* state, size_t size)
+{
+    if (size < sizeof(BoardHeader) || size % sizeof(uint64_t) != 0)
+        return false;
+    
+    // The header has to be from this version and describe a state of exactly this size
+    BoardHeader loaded;
+    memcpy(&loaded, state, sizeof(BoardHeader));
+    if (loaded.version != BOARD_STATE_VERSION || loaded.width <= 0 || loaded.height <= 0 || loaded.rowWords != (loaded.width + 63) / 64 || loaded.snakeCapacity < 0 || loaded.foodCapacity < 0)
+        return false;
+    if (stateSize(loaded) != size)
+        return false;
+    
+    mState.resize(size / sizeof(uint64_t));
+    memcpy(mState.data(), state, size);
+    layout();
+    
+    // Nothing is known about which pages match an earlier snapshot any more
+    mBaseSnapshot = 0;
+    
+    return true;
+}
+
+void Board::snapshot(BoardSnapshot &snapshot)
+{
+    // A snapshot is a plain copy of the flat state
+    snapshot.data.resize(mState.size());
+    memcpy(snapshot.data.data(), mState.data(), getStateSize());
+    snapshot.id = nextSnapshotId++;
+    
+    // Changes are tracked against the new snapshot from here on
+    std::fill(mDirtyPages.begin(), mDirtyPages.end(), 0);
+    mBaseSnapshot = snapshot.id;
+}
+
+void Board::restore(const BoardSnapshot &snapshot)
+{
+    size_t size = snapshot.data.size() * sizeof(uint64_t);
+    
+    // Any other snapshot needs the whole state copied, after which changes are tracked against it
+    if (snapshot.id == 0 || snapshot.id != mBaseSnapshot || size != getStateSize())
+    {
+        if (loadState(snapshot.data.data(), size))
+            mBaseSnapshot = snapshot.id;
+        return;
+    }
+    
+    uint8_t* destination = (uint8_t*) mState.data();
+    const uint8_t* source = (const uint8_t*) snapshot.data.data();
+    
+    // Once half of the state was written one streaming copy beats many scattered ones
+    size_t dirty = 0;
+    for (uint64_t pages : mDirtyPages)
+        dirty += __builtin_popcountll(pages);
+    if (dirty * BOARD_PAGE_SIZE * 2 > size)
+    {
+        memcpy(destination, source, size);
+        std::fill(mDirtyPages.begin(), mDirtyPages.end(), 0);
+        return;
+    }
+    
+    // Only the pages written since the snapshot can differ from it
+    for (size_t word = 0; word < mDirtyPages.size(); word++)
+    {
+        uint64_t pages = mDirtyPages[word];
+        while (pages)
+        {
+            size_t offset = (word * 64 + __builtin_ctzll(pages)) * BOARD_PAGE_SIZE;
+            pages &= pages - 1;
+            
+            memcpy(destination + offset, source + offset, std::min(BOARD_PAGE_SIZE, size - offset));
+        }
+        
+        mDirtyPages[word] = 0;
+    }
+}
+
+size_t Board::stateSize(const BoardHeader &state)
+{
+    // Header, cells, occupancy bits, snake slots and food, each starting on a word boundary
+    return alignWord(sizeof(BoardHeader)) + alignWord((size_t) state.width * state.height) + (size_t) state.rowWords * state.height * sizeof(uint64_t) + alignWord(state.snakeCapacity * sizeof(Snake)) + alignWord(state.foodCapacity * sizeof(int32_t));
+}
+
+void Board::layout()
+{
+    const BoardHeader &state = header();
+    mWidth = state.width;
+    mHeight = state.height;
+    mRowWords = state.rowWords;
+    
+    // Sections follow the header in the same order stateSize counts them
+    mCellsOffset = alignWord(sizeof(BoardHeader));
+    mOccupancyOffset = mCellsOffset + alignWord((size_t) mWidth * mHeight);
+    mSnakesOffset = mOccupancyOffset + (size_t) mRowWords * mHeight * sizeof(uint64_t);
+    mFoodOffset = mSnakesOffset + alignWord(state.snakeCapacity * sizeof(Snake));
+    
+    size_t size = stateSize(state);
+    mState.resize(size / sizeof(uint64_t), 0);
+    
+    // One dirty bit per page of state
+    size_t pages = (size + BOARD_PAGE_SIZE - 1) / BOARD_PAGE_SIZE;
+    mDirtyPages.assign((pages + 63) / 64, 0);
+}
+
+BoardHeader &Board::header()
+{
+    return *(BoardHeader*) mState.data();
+}
+
+const BoardHeader &Board::header() const
+{
+    return *(const BoardHeader*) mState.data();
+}
+
+uint8_t* Board::cells()
+{
+    return (uint8_t*) mState.data() + mCellsOffset;
+}
+
+const uint8_t* Board::cells() const
+{
+    return (const uint8_t*) mState.data() + mCellsOffset;
+}
+
+uint64_t* Board::occupancy()
+{
+    return (uint64_t*) ((uint8_t*) mState.data() + mOccupancyOffset);
+}
+
+const uint64_t* Board::occupancy() const
+{
+    return (const uint64_t*) ((const uint8_t*) mState.data() + mOccupancyOffset);
+}
+
+Snake* Board::snakes()
+{
+    return (Snake*) ((uint8_t*) mState.data() + mSnakesOffset);
+}
+
+const Snake* Board::snakes() const
+{
+    return (const Snake*) ((const uint8_t*) mState.data() + mSnakesOffset);
+}
+
+int32_t* Board::food()
+{
+    return (int32_t*) ((uint8_t*) mState.data() + mFoodOffset);
+}
+
+const int32_t* Board::food() const
+{
+    return (const int32_t*) ((const uint8_t*) mState.data() + mFoodOffset);
+}
+
+void Board::markDirty(const void* address, size_t size)
+{
+    // Sets the bit of every page the range touches, which is nearly always just one
+    size_t first = (const uint8_t*) address - (const uint8_t*) mState.data();
+    size_t last = first + size - 1;
+    
+    for (size_t page = first / BOARD_PAGE_SIZE; page <= last / BOARD_PAGE_SIZE; page++)
+        mDirtyPages[page / 64] |= 1ull << (page % 64);
+}
+
+void Board::setCell(int cell, uint8_t value)
+{
+    cells()[cell] = value;
+    markDirty(&cells()[cell], 1);
+    
+    // Mirrors body cells into the occupancy bitset used by path searches
+    int x = cell % mWidth, y = cell / mWidth;
+    uint64_t &word = occupancy()[y * mRowWords + x / 64];
+    uint64_t bit = 1ull << (x % 64);
+    if (value >= CELL_BODY)
+        word |= bit;
+    else
+        word &= ~bit;
+    markDirty(&word, sizeof(uint64_t));
+}
+
+void Board::killSnake(Snake &snake)
+{
+    // Follows the links from the tail up to the head and clears every segment
+    int cell = snake.tail;
+    while (cell != snake.head)
+    {
+        int next = getNeighbor(cell, (Direction) (cells()[cell] - CELL_BODY));
+        setCell(cell, CELL_EMPTY);
+        cell = next;
+    }
+    setCell(snake.head, CELL_EMPTY);
+    
+    snake.alive = false;
+    markDirty(&snake, sizeof(Snake));
+}
+
+void Board::removeFood(int cell)
+{
+    BoardHeader &state = header();
+    int32_t* list = food();
+    
+    // Swap removal, food order does not matter
+    int32_t* found = std::find(list, list + state.foodCount, cell);
+    if (found != list + state.foodCount)
+    {
+        *found = list[state.foodCount - 1];
+        markDirty(found, sizeof(int32_t));
+        state.foodCount--;
+        markDirty(&state, sizeof(BoardHeader));
+    }
+    
+    setCell(cell, CELL_EMPTY);
+}
+
+uint32_t Board::random()
+{
+    uint32_t &seed = header().seed;
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    markDirty(&seed, sizeof(uint32_t));
+    
+    return seed;
+}
+
+Direction oppositeDirection(Direction direction)
+{
+    return (Direction) ((direction + 2) % 4);
+}
@@ -0,0 +1,194 @@
+//
+//  board.hpp
+//  SnakeGL
+//
+//  Created by Keegan Bilodeau on 10/19/26.
+//  Copyright © 2026 Keegan Bilodeau. All rights reserved.
+//
+
+#ifndef board_hpp
+#define board_hpp
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+// Directions a snake can move on the board (north is +y)
+enum Direction
+{
+    NORTH,
+    EAST,
+    SOUTH,
+    WEST
+};
+
+// Cell contents, body cells store the direction towards the next segment (closer to the head)
+enum CellType
+{
+    CELL_EMPTY = 0,
+    CELL_FOOD = 1,
+    CELL_BODY = 2,
+    CELL_HEAD = CELL_BODY + 4
+};
+
+// Bumped whenever the layout of a board's flat state changes
+const uint32_t BOARD_STATE_VERSION = 1;
+
+// Granularity of the change tracking used for delta restores
+const size_t BOARD_PAGE_SIZE = 512;
+
+// A single snake, its body is linked through the board's cells from tail to head
+struct Snake
+{
+    // Cell indices of the head and tail
+    int head, tail;
+    
+    // Number of cells the body covers and the number of cells it still has to grow
+    int length, growth;
+    
+    // Direction of the last move and the one that will be taken next tick
+    Direction direction, nextDirection;
+    
+    bool alive;
+    unsigned int score;
+};
+
+// Start of a board's flat state, followed by the cells, occupancy bits, snake slots and food
+struct BoardHeader
+{
+    uint32_t version;
+    int32_t width, height, rowWords;
+    int32_t snakeCount, snakeCapacity, foodCount, foodCapacity, foodTarget;
+    uint32_t seed;
+    uint64_t tick;
+};
+
+// Full copy of a board's state, taken with Board::snapshot
+struct BoardSnapshot
+{
+    std::vector<uint64_t> data;
+    
+    // Identifies the snapshot so a board can tell whether it is still tracking changes against it
+    uint64_t id = 0;
+};
+
+// Grid that holds every snake and piece of food
+// All of the board's state lives in one flat, trivially copyable block whose size is fixed by the
+// dimensions and capacities given to the constructor, so copying a board is a single memcpy
+class Board
+{
+public:
+    // Creates an empty board, seed drives food placement
+    Board(int width, int height, unsigned int seed = 1, int maxSnakes = 16, int maxFood = 64);
+    
+    // Places a snake with its head at (x, y) and its body trailing behind it, returns its index or -1 if it does not fit
+    // Snakes are at least two cells long, and dead snakes' slots are reused
+    int addSnake(int x, int y, Direction direction, int length = 3);
+    
+    // Queues a direction change for the next tick, turning back onto the body is ignored
+    void setDirection(int snake, Direction direction);
+    
+    // Takes a live snake off the board as if it had died, for example when its player leaves
+    void removeSnake(int snake);
+    
+    // Advances every live snake by one cell
+    void tick();
+    
+    // Places food on a random empty cell, returns false if the board or the food list is full
+    bool spawnFood();
+    
+    // Number of food items the board keeps spawned (limited by the food capacity)
+    void setFoodTarget(int count);
+    
+    // Board dimensions
+    int getWidth() const;
+    int getHeight() const;
+    
+    // Number of ticks simulated so far
+    uint64_t getTick() const;
+    
+    // Cell accessors, cells are indexed as y * width + x
+    uint8_t getCell(int cell) const;
+    bool isOccupied(int cell) const;
+    bool isFood(int cell) const;
+    
+    // Returns the cell next to the given one or -1 if that would leave the board
+    int getNeighbor(int cell, Direction direction) const;
+    
+    // Row aligned occupancy bitset, bit x of row y is word y * getRowWords() + x / 64
+    const uint64_t* getOccupancy() const;
+    int getRowWords() const;
+    
+    // Snake slots (including dead snakes) and the food currently on the board
+    int getSnakeCount() const;
+    const Snake &getSnake(int snake) const;
+    int getFoodCount() const;
+    const int32_t* getFood() const;
+    
+    // The board's flat state
+    const void* getState() const;
+    size_t getStateSize() const;
+    
+    // Replaces the board with a flat state from getState, returns false if the state is not valid
+    bool loadState(const void* state, size_t size);
+    
+    // Copies the whole state into the snapshot and starts tracking changes against it
+    void snapshot(BoardSnapshot &snapshot);
+    
+    // Returns to a snapshot, only the pages written since the snapshot was taken (or last restored)
+    // are copied back when the board is still tracking against it, otherwise the whole state is copied
+    void restore(const BoardSnapshot &snapshot);
+
+private:
+    // Size in bytes of the flat state a header describes
+    static size_t stateSize(const BoardHeader &state);
+    
+    // Computes the offsets of every section of the flat state from the header
+    void layout();
+    
+    // Section accessors for the flat state
+    BoardHeader &header();
+    const BoardHeader &header() const;
+    uint8_t* cells();
+    const uint8_t* cells() const;
+    uint64_t* occupancy();
+    const uint64_t* occupancy() const;
+    Snake* snakes();
+    const Snake* snakes() const;
+    int32_t* food();
+    const int32_t* food() const;
+    
+    // Records that a range of the flat state was written
+    void markDirty(const void* address, size_t size);
+    
+    // Writes a cell and keeps the occupancy bitset in sync
+    void setCell(int cell, uint8_t value);
+    
+    // Removes a snake's body from the board
+    void killSnake(Snake &snake);
+    
+    // Removes one piece of food from the food list
+    void removeFood(int cell);
+    
+    // Xorshift random number generator for food placement
+    uint32_t random();
+    
+    // Flat state, stored as words so every section is 8 byte aligned
+    std::vector<uint64_t> mState;
+    
+    // Byte offsets of the sections inside the flat state
+    size_t mCellsOffset, mOccupancyOffset, mSnakesOffset, mFoodOffset;
+    
+    // Copies of the immutable header fields for the hot paths
+    int mWidth, mHeight, mRowWords;
+    
+    // One bit per page written since the tracked snapshot, and that snapshot's id
+    std::vector<uint64_t> mDirtyPages;
+    uint64_t mBaseSnapshot;
+};
+
+// Returns the direction pointing the opposite way
+Direction oppositeDirection(Direction direction);
+
+#endif /* board_hpp */
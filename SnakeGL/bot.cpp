@@ -0,0 +1,370 @@
+//
+//  bot.cpp
+//  SnakeGL
+//
+//  Created by Keegan Bilodeau on 10/19/26.
+//  Copyright © 2026 Keegan Bilodeau. All rights reserved.
+//
+
+#include "bot.hpp"
+
+#include <algorithm>
+#include <string.h>
+
+BotController::BotController() : decisions(0), searches(0), cacheHits(0), mEpoch(0), mWidth(0), mHeight(0)
+{
+}
+
+void BotController::addBot(int snake)
+{
+    if (isBot(snake))
+        return;
+    
+    if ((int) mBotIndex.size() <= snake)
+        mBotIndex.resize(snake + 1, -1);
+    
+    mBotIndex[snake] = (int) mBots.size();
+    mBots.push_back(BotMemory{snake, std::vector<int>(), 0});
+}
+
+void BotController::removeBot(int snake)
+{
+    if (!isBot(snake))
+        return;
+    
+    // Swap removal, the moved bot's index has to follow it
+    int slot = mBotIndex[snake];
+    mBots[slot] = std::move(mBots.back());
+    mBotIndex[mBots[slot].snake] = slot;
+    mBots.pop_back();
+    mBotIndex[snake] = -1;
+}
+
+bool BotController::isBot(int snake) const
+{
+    return snake >= 0 && snake < (int) mBotIndex.size() && mBotIndex[snake] >= 0;
+}
+
+void BotController::update(Board &board)
+{
+    prepare(board);
+    
+    for (BotMemory &memory : mBots)
+    {
+        const Snake &snake = board.getSnake(memory.snake);
+        if (snake.alive)
+            board.setDirection(memory.snake, decide(board, snake, memory));
+    }
+}
+
+Direction BotController::decide(const Board &board, int snake)
+{
+    prepare(board);
+    
+    // Snakes that were never added get a memory that only lasts for this decision
+    if (!isBot(snake))
+    {
+        BotMemory memory{snake, std::vector<int>(), 0};
+        return decide(board, board.getSnake(snake), memory);
+    }
+    
+    return decide(board, board.getSnake(snake), mBots[mBotIndex[snake]]);
+}
+
+Direction BotController::decide(const Board &board, const Snake &snake, BotMemory &memory)
+{
+    decisions++;
+    
+    // Only searches again if the board changed somewhere along the remembered path
+    if (pathValid(board, snake, memory))
+        cacheHits++;
+    else
+    {
+        searches++;
+        memory.step = 0;
+        if (!findPath(board, snake, memory.path))
+            memory.path.clear();
+    }
+    
+    // Tries the path's move first, then keeps going straight before trying to turn
+    Direction candidates[4];
+    int candidateCount = 0;
+    bool followsPath = memory.step < memory.path.size();
+    if (followsPath)
+        for (int d = 0; d < 4; d++)
+            if (board.getNeighbor(snake.head, (Direction) d) == memory.path[memory.step])
+                candidates[candidateCount++] = (Direction) d;
+    if (std::find(candidates, candidates + candidateCount, snake.direction) == candidates + candidateCount)
+        candidates[candidateCount++] = snake.direction;
+    for (int d = 0; d < 4; d++)
+        if (std::find(candidates, candidates + candidateCount, (Direction) d) == candidates + candidateCount)
+            candidates[candidateCount++] = (Direction) d;
+    
+    // The first legal move that keeps the tail reachable wins
+    int fallback = -1;
+    for (int i = 0; i < candidateCount; i++)
+    {
+        int next = board.getNeighbor(snake.head, candidates[i]);
+        if (next < 0 || candidates[i] == oppositeDirection(snake.direction))
+            continue;
+        
+        // The tail cell is only safe to enter if the tail moves away this tick
+        bool tailMoves = next == snake.tail && snake.growth == 0;
+        if (board.isOccupied(next) && !tailMoves)
+            continue;
+        
+        if (fallback < 0)
+            fallback = candidates[i];
+        
+        if (tailReachable(board, snake, next))
+        {
+            // Leaving the path means it has to be searched again next tick
+            if (followsPath && next == memory.path[memory.step])
+                memory.step++;
+            else
+                memory.path.clear();
+            
+            return candidates[i];
+        }
+    }
+    
+    memory.path.clear();
+    
+    // Nothing is safe, take any legal move and hope the board opens up
+    return fallback >= 0 ? (Direction) fallback : snake.direction;
+}
+
+bool BotController::pathValid(const Board &board, const Snake &snake, const BotMemory &memory) const
+{
+    if (memory.step >= memory.path.size())
+        return false;
+    
+    // The next cell has to be right next to where the head ended up
+    bool adjacent = false;
+    for (int d = 0; d < 4; d++)
+        adjacent |= board.getNeighbor(snake.head, (Direction) d) == memory.path[memory.step];
+    if (!adjacent)
+        return false;
+    
+    // The board only changes at heads and tails, so a path is still good as long as nothing moved onto it
+    for (size_t i = memory.step; i < memory.path.size(); i++)
+        if (board.isOccupied(memory.path[i]))
+            return false;
+    
+    // And the food at its end must still be there
+    return board.isFood(memory.path.back());
+}
+
+bool BotController::findPath(const Board &board, const Snake &snake, std::vector<int> &path)
+{
+    path.clear();
+    
+    int food = search(board, snake.head, -1, -1, -1, -1, true);
+    if (food < 0)
+        return false;
+    
+    // Walks back from the food along decreasing distances until the head is reached
+    int cell = food;
+    while (mDistance[cell] > 0)
+    {
+        path.push_back(cell);
+        
+        for (int d = 0; d < 4; d++)
+        {
+            int neighbor = board.getNeighbor(cell, (Direction) d);
+            if (neighbor >= 0 && mStamp[neighbor] == mEpoch && mDistance[neighbor] == mDistance[cell] - 1)
+            {
+                cell = neighbor;
+                break;
+            }
+        }
+    }
+    
+    // The walk went from food to head, so it is flipped to run head to food
+    std::reverse(path.begin(), path.end());
+    
+    return true;
+}
+
+bool BotController::tailReachable(const Board &board, const Snake &snake, int nextCell)
+{
+    // When the snake grows the tail stays put, otherwise the old tail cell frees up and the tail
+    // moves one segment forward
+    bool grows = snake.growth > 0 || board.isFood(nextCell);
+    int tail = grows ? snake.tail : board.getNeighbor(snake.tail, (Direction) (board.getCell(snake.tail) - CELL_BODY));
+    int freed = grows ? -1 : snake.tail;
+    
+    // A two cell snake always has its tail right behind the head
+    if (tail == nextCell || tail == snake.head)
+        return true;
+    
+    return search(board, nextCell, tail, snake.head, freed, tail, false) == tail;
+}
+
+int BotController::search(const Board &board, int start, int target, int blocked, int freedA, int freedB, bool recordDistance)
+{
+    const uint64_t* occupancy = board.getOccupancy();
+    int rowWords = board.getRowWords();
+    
+    // Stamps mark which distances belong to this search, so the distance array never needs clearing
+    mEpoch++;
+    if (mEpoch == 0)
+    {
+        std::fill(mStamp.begin(), mStamp.end(), 0);
+        mEpoch = 1;
+    }
+    
+    // Free cells of one word, with the overrides applied
+    auto freeWord = [&](int row, int word) -> uint64_t
+    {
+        uint64_t free = ~occupancy[row * rowWords + word] & mColumnMask[word];
+        
+        int overrides[3] = {blocked, freedA, freedB};
+        for (int i = 0; i < 3; i++)
+        {
+            int cell = overrides[i];
+            if (cell < 0 || cell / mWidth != row || (cell % mWidth) / 64 != word)
+                continue;
+            
+            uint64_t bit = 1ull << ((cell % mWidth) % 64);
+            free = i == 0 ? free & ~bit : free | bit;
+        }
+        
+        return free;
+    };
+    
+    int startRow = start / mWidth, startX = start % mWidth;
+    mFrontier[startRow * rowWords + startX / 64] = 1ull << (startX % 64);
+    mVisited[startRow * rowWords + startX / 64] = 1ull << (startX % 64);
+    if (recordDistance)
+    {
+        mStamp[start] = mEpoch;
+        mDistance[start] = 0;
+    }
+    
+    // Rows the frontier and visited set currently span
+    int minRow = startRow, maxRow = startRow, visitedMin = startRow, visitedMax = startRow;
+    int found = -1;
+    
+    for (uint32_t distance = 1; found < 0; distance++)
+    {
+        // Only rows next to the frontier can gain new cells
+        int low = std::max(0, minRow - 1), high = std::min(mHeight - 1, maxRow + 1);
+        int newMin = mHeight, newMax = -1;
+        
+        for (int row = low; row <= high; row++)
+        {
+            uint64_t* frontier = &mFrontier[row * rowWords];
+            uint64_t* next = &mNext[row * rowWords];
+            const uint64_t* visited = &mVisited[row * rowWords];
+            bool rowActive = false;
+            
+            for (int word = 0; word < rowWords; word++)
+            {
+                // Shifting a row by one bit moves every frontier cell sideways, carrying across words
+                uint64_t east = (frontier[word] << 1) | (word > 0 ? frontier[word - 1] >> 63 : 0);
+                uint64_t west = (frontier[word] >> 1) | (word + 1 < rowWords ? frontier[word + 1] << 63 : 0);
+                // Frontier cells in the rows below and above move north and south
+                uint64_t north = row > 0 ? frontier[word - rowWords] : 0;
+                uint64_t south = row + 1 < mHeight ? frontier[word + rowWords] : 0;
+                
+                uint64_t cells = (east | west | north | south) & ~visited[word];
+                if (cells)
+                    cells &= freeWord(row, word);
+                
+                next[word] = cells;
+                rowActive |= cells != 0;
+            }
+            
+            if (rowActive)
+            {
+                newMin = std::min(newMin, row);
+                newMax = std::max(newMax, row);
+            }
+        }
+        
+        // The old frontier is cleared so the buffer can be swapped in as the next one
+        for (int row = minRow; row <= maxRow; row++)
+            memset(&mFrontier[row * rowWords], 0, rowWords * sizeof(uint64_t));
+        
+        mFrontier.swap(mNext);
+        
+        // Nothing new was reached, the target is walled off
+        if (newMax < 0)
+            break;
+        
+        minRow = newMin;
+        maxRow = newMax;
+        visitedMin = std::min(visitedMin, minRow);
+        visitedMax = std::max(visitedMax, maxRow);
+        
+        for (int row = minRow; row <= maxRow && found < 0; row++)
+        {
+            for (int word = 0; word < rowWords; word++)
+            {
+                uint64_t cells = mFrontier[row * rowWords + word];
+                mVisited[row * rowWords + word] |= cells;
+                
+                // A single target only needs one bit tested
+                if (target >= 0)
+                {
+                    if (target / mWidth == row && (target % mWidth) / 64 == word && (cells >> ((target % mWidth) % 64) & 1))
+                        found = target;
+                    continue;
+                }
+                
+                // Visits every newly reached cell to record its distance and look for food
+                while (cells)
+                {
+                    int bit = __builtin_ctzll(cells);
+                    cells &= cells - 1;
+                    
+                    int cell = row * mWidth + word * 64 + bit;
+                    if (recordDistance)
+                    {
+                        mStamp[cell] = mEpoch;
+                        mDistance[cell] = distance;
+                    }
+                    
+                    if (found < 0 && board.isFood(cell))
+                        found = cell;
+                }
+            }
+        }
+    }
+    
+    // Leaves the scratch bitsets empty for the next search
+    for (int row = visitedMin; row <= visitedMax; row++)
+    {
+        memset(&mVisited[row * rowWords], 0, rowWords * sizeof(uint64_t));
+        memset(&mFrontier[row * rowWords], 0, rowWords * sizeof(uint64_t));
+    }
+    
+    return found;
+}
+
+void BotController::prepare(const Board &board)
+{
+    if (board.getWidth() == mWidth && board.getHeight() == mHeight)
+        return;
+    
+    mWidth = board.getWidth();
+    mHeight = board.getHeight();
+    
+    int rowWords = board.getRowWords();
+    mFrontier.assign(rowWords * mHeight, 0);
+    mNext.assign(rowWords * mHeight, 0);
+    mVisited.assign(rowWords * mHeight, 0);
+    mDistance.assign(mWidth * mHeight, 0);
+    mStamp.assign(mWidth * mHeight, 0);
+    mEpoch = 0;
+    
+    // Masks off the padding bits past the right edge of each row
+    mColumnMask.assign(rowWords, ~0ull);
+    if (mWidth % 64)
+        mColumnMask[rowWords - 1] = (1ull << (mWidth % 64)) - 1;
+    
+    // Remembered paths belong to a different board now
+    for (BotMemory &memory : mBots)
+        memory.path.clear();
+}
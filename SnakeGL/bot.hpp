@@ -0,0 +1,82 @@
+//
+//  bot.hpp
+//  SnakeGL
+//
+//  Created by Keegan Bilodeau on 10/19/26.
+//  Copyright © 2026 Keegan Bilodeau. All rights reserved.
+//
+
+#ifndef bot_hpp
+#define bot_hpp
+
+#include <stdio.h>
+#include <stdint.h>
+#include <vector>
+
+#include "board.hpp"
+
+// Steers snakes towards food while making sure they can always reach their own tail
+// Searches expand whole 64 cell words per step over the board's occupancy bitset, and
+// the path found for each bot is kept and only searched again once it becomes invalid
+class BotController
+{
+public:
+    BotController();
+    
+    // Hands a snake over to the controller (or takes it back)
+    void addBot(int snake);
+    void removeBot(int snake);
+    bool isBot(int snake) const;
+    
+    // Picks and applies the next direction for every controlled snake that is still alive
+    void update(Board &board);
+    
+    // Picks the next direction for a single snake
+    Direction decide(const Board &board, int snake);
+    
+    // Counters for decisions made, searches run and decisions served from a cached path
+    uint64_t decisions, searches, cacheHits;
+
+private:
+    // Per snake search state that survives between ticks
+    struct BotMemory
+    {
+        int snake;
+        
+        // Cells from the head to the food, step is the next cell to enter
+        std::vector<int> path;
+        size_t step;
+    };
+    
+    // Picks the next direction for a snake using and updating its memory
+    Direction decide(const Board &board, const Snake &snake, BotMemory &memory);
+    
+    // Returns true if the cached path can still be followed from the snake's head
+    bool pathValid(const Board &board, const Snake &snake, const BotMemory &memory) const;
+    
+    // Breadth first search from the head to the closest food, fills path with the cells to walk
+    bool findPath(const Board &board, const Snake &snake, std::vector<int> &path);
+    
+    // Flood fills from the cell the head would move into and checks the tail is still reachable
+    bool tailReachable(const Board &board, const Snake &snake, int nextCell);
+    
+    // Bitset breadth first search from start over free cells
+    // Stops at target, or at the first food cell when target is -1, and returns the cell reached or -1
+    // blocked is treated as occupied and freedA/freedB as free, distances are recorded if requested
+    int search(const Board &board, int start, int target, int blocked, int freedA, int freedB, bool recordDistance);
+    
+    // Sizes the scratch buffers for the board
+    void prepare(const Board &board);
+    
+    // Controlled snakes and the slot each snake's memory lives in (-1 if not controlled)
+    std::vector<BotMemory> mBots;
+    std::vector<int> mBotIndex;
+    
+    // Search scratch, reused for every search so that steady state ticks never allocate
+    std::vector<uint64_t> mFrontier, mNext, mVisited, mColumnMask;
+    std::vector<uint32_t> mDistance, mStamp;
+    uint32_t mEpoch;
+    int mWidth, mHeight;
+};
+
+#endif /* bot_hpp */
@@ -101,6 +101,26 @@ float &Camera::getFOV()
     return mFov;
 }
 
+CameraState Camera::getState() const
+{
+    return CameraState{mCameraPos, mWorldUp, mPitch, mYaw, mFov, mMovementSpeed, mMouseSensitivity, mCameraFixed};
+}
+
+void Camera::setState(const CameraState &state)
+{
+    mCameraPos = state.position;
+    mWorldUp = state.worldUp;
+    mPitch = state.pitch;
+    mYaw = state.yaw;
+    mFov = state.fov;
+    mMovementSpeed = state.movementSpeed;
+    mMouseSensitivity = state.mouseSensitivity;
+    mCameraFixed = state.fixed;
+    
+    // The front, right and up vectors follow from the restored angles
+    updateCameraVectors();
+}
+
 void Camera::updateCameraVectors()
 {
     glm::vec3 direction;
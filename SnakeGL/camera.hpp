@@ -26,6 +26,14 @@ enum CameraMovement
 // Basic camera default constants
 const float YAW = -90.0f, PITCH = 0.0f, SPEED = 2.5, SENSITIVITY = 0.1f, ZOOM = 45.0f;
 
+// Everything needed to put a camera back where it was, the direction vectors are derived from the angles
+struct CameraState
+{
+    glm::vec3 position, worldUp;
+    float pitch, yaw, fov, movementSpeed, mouseSensitivity;
+    bool fixed;
+};
+
 class Camera
 {
 public:
@@ -50,6 +58,10 @@ public:
     // Returns the camera's fov for the projection matrix calculation
     float &getFOV();
     
+    // Copies the camera's state out or replaces it, used for saving and loading
+    CameraState getState() const;
+    void setState(const CameraState &state);
+
 private:
     // Used by the camera to update its vectors after movement calculations
     void updateCameraVectors();
@@ -0,0 +1,254 @@
+//
+//  jobs.cpp
+//  SnakeGL
+//
+//  Created by Keegan Bilodeau on 10/19/26.
+//  Copyright © 2026 Keegan Bilodeau. All rights reserved.
+//
+
+#include "jobs.hpp"
+
+#include <algorithm>
+
+int JobGraph::add(const char* name, std::function<void()> work, JobAffinity affinity)
+{
+    mJobs.emplace_back();
+    Job &job = mJobs.back();
+    job.name = name;
+    job.work = std::move(work);
+    job.affinity = affinity;
+    job.dependencyCount = 0;
+    job.remaining = 0;
+    job.start = job.end = 0.0;
+    
+    return (int) mJobs.size() - 1;
+}
+
+void JobGraph::depend(int job, int dependency)
+{
+    mJobs[dependency].dependents.push_back(job);
+    mJobs[job].dependencyCount++;
+}
+
+size_t JobGraph::size() const
+{
+    return mJobs.size();
+}
+
+const std::string &JobGraph::getName(int job) const
+{
+    return mJobs[job].name;
+}
+
+float JobGraph::getTime(int job) const
+{
+    return (float) ((mJobs[job].end - mJobs[job].start) * 1000.0);
+}
+
+JobSystem::JobSystem(int workers) : mGraph(nullptr), mQueued(0), mMainQueued(0), mUnfinished(0), mStopping(false), mEpoch(std::chrono::steady_clock::now()), mTracing(false)
+{
+    if (workers < 0)
+        workers = std::max(0, (int) std::thread::hardware_concurrency() - 1);
+    
+    for (int thread = 0; thread <= workers; thread++)
+        mQueues.emplace_back(new WorkQueue());
+    for (int thread = 1; thread <= workers; thread++)
+        mThreads.emplace_back(&JobSystem::workerLoop, this, thread);
+}
+
+JobSystem::~JobSystem()
+{
+    mStopping = true;
+    wake();
+    
+    for (std::thread &thread : mThreads)
+        thread.join();
+}
+
+void JobSystem::run(JobGraph &graph)
+{
+    if (graph.mJobs.empty())
+        return;
+    
+    mGraph = &graph;
+    mUnfinished = (int) graph.mJobs.size();
+    for (JobGraph::Job &job : graph.mJobs)
+        job.remaining = job.dependencyCount;
+    
+    // Jobs without dependencies start right away, the rest are released as their dependencies finish
+    for (size_t job = 0; job < graph.mJobs.size(); job++)
+        if (graph.mJobs[job].dependencyCount == 0)
+            schedule((int) job, 0);
+    
+    while (mUnfinished > 0)
+    {
+        // Context bound jobs come first, since no other thread can take them
+        int job = -1;
+        {
+            std::lock_guard<std::mutex> lock(mMainQueue.mutex);
+            if (!mMainQueue.jobs.empty())
+            {
+                job = mMainQueue.jobs.front();
+                mMainQueue.jobs.pop_front();
+                mMainQueued--;
+            }
+        }
+        
+        if (job >= 0 || takeJob(0, job))
+        {
+            execute(job, 0);
+            continue;
+        }
+        
+        std::unique_lock<std::mutex> lock(mSleepMutex);
+        mWake.wait(lock, [this] { return mUnfinished == 0 || mQueued > 0 || mMainQueued > 0; });
+    }
+    
+    mGraph = nullptr;
+}
+
+unsigned int JobSystem::getThreadCount() const
+{
+    return (unsigned int) mQueues.size();
+}
+
+void JobSystem::startTrace()
+{
+    std::lock_guard<std::mutex> lock(mTraceMutex);
+    mTrace.clear();
+    mTracing = true;
+}
+
+bool JobSystem::isTracing() const
+{
+    return mTracing;
+}
+
+bool JobSystem::writeTrace(const char* path)
+{
+    std::lock_guard<std::mutex> lock(mTraceMutex);
+    mTracing = false;
+    
+    FILE* file = fopen(path, "w");
+    if (file == nullptr)
+    {
+        printf("ERROR::JOBS::TRACE_NOT_WRITTEN\n%s\n", path);
+        return false;
+    }
+    
+    // Complete events, timestamps and durations are in microseconds
+    fputs("{\"traceEvents\":[\n", file);
+    for (size_t i = 0; i < mTrace.size(); i++)
+    {
+        const TraceEvent &event = mTrace[i];
+        fprintf(file, "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}%s\n", event.name.c_str(), event.thread, event.start * 1.0e6, (event.end - event.start) * 1.0e6, i + 1 < mTrace.size() ? "," : "");
+    }
+    fputs("],\"displayTimeUnit\":\"ms\"}\n", file);
+    
+    fclose(file);
+    mTrace.clear();
+    
+    return true;
+}
+
+void JobSystem::workerLoop(unsigned int thread)
+{
+    while (!mStopping)
+    {
+        int job;
+        if (takeJob(thread, job))
+        {
+            execute(job, thread);
+            continue;
+        }
+        
+        std::unique_lock<std::mutex> lock(mSleepMutex);
+        mWake.wait(lock, [this] { return mStopping || mQueued > 0; });
+    }
+}
+
+bool JobSystem::takeJob(unsigned int thread, int &job)
+{
+    // Newest job from the thread's own deque
+    {
+        WorkQueue &own = *mQueues[thread];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.jobs.empty())
+        {
+            job = own.jobs.back();
+            own.jobs.pop_back();
+            mQueued--;
+            return true;
+        }
+    }
+    
+    // Oldest job of the next thread that has one
+    for (size_t offset = 1; offset < mQueues.size(); offset++)
+    {
+        WorkQueue &victim = *mQueues[(thread + offset) % mQueues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.jobs.empty())
+        {
+            job = victim.jobs.front();
+            victim.jobs.pop_front();
+            mQueued--;
+            return true;
+        }
+    }
+    
+    return false;
+}
+
+void JobSystem::schedule(int job, unsigned int thread)
+{
+    if (mGraph->mJobs[job].affinity == JOB_MAIN)
+    {
+        std::lock_guard<std::mutex> lock(mMainQueue.mutex);
+        mMainQueue.jobs.push_back(job);
+        mMainQueued++;
+    }
+    else
+    {
+        std::lock_guard<std::mutex> lock(mQueues[thread]->mutex);
+        mQueues[thread]->jobs.push_back(job);
+        mQueued++;
+    }
+    
+    wake();
+}
+
+void JobSystem::execute(int job, unsigned int thread)
+{
+    JobGraph::Job &current = mGraph->mJobs[job];
+    current.start = now();
+    current.work();
+    current.end = now();
+    
+    if (mTracing)
+    {
+        std::lock_guard<std::mutex> lock(mTraceMutex);
+        mTrace.push_back(TraceEvent{current.name, current.start, current.end, thread});
+    }
+    
+    // The last dependency to finish releases a dependent onto this thread's deque
+    for (int dependent : current.dependents)
+        if (mGraph->mJobs[dependent].remaining.fetch_sub(1) == 1)
+            schedule(dependent, thread);
+    
+    if (mUnfinished.fetch_sub(1) == 1)
+        wake();
+}
+
+void JobSystem::wake()
+{
+    // Taking the lock orders the wake up after any thread that is about to sleep checked its condition
+    {
+        std::lock_guard<std::mutex> lock(mSleepMutex);
+    }
+    mWake.notify_all();
+}
+
+double JobSystem::now() const
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - mEpoch).count();
+}
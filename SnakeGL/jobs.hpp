@@ -0,0 +1,153 @@
+//
+//  jobs.hpp
+//  SnakeGL
+//
+//  Created by Keegan Bilodeau on 10/19/26.
+//  Copyright © 2026 Keegan Bilodeau. All rights reserved.
+//
+
+#ifndef jobs_hpp
+#define jobs_hpp
+
+#include <stdio.h>
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Which threads may run a job
+enum JobAffinity
+{
+    // Any worker, or the thread that runs the graph while it waits
+    JOB_ANY,
+    // Only the thread that runs the graph, for work that needs the GL context
+    JOB_MAIN
+};
+
+// A set of jobs and the dependencies between them, built once and run every frame
+class JobGraph
+{
+public:
+    // Adds a job and returns its id, jobs run in any order their dependencies allow
+    int add(const char* name, std::function<void()> work, JobAffinity affinity = JOB_ANY);
+    
+    // Makes job wait until dependency has finished
+    void depend(int job, int dependency);
+    
+    // Number of jobs in the graph
+    size_t size() const;
+    
+    // Name, and the time in milliseconds the job took during the last run
+    const std::string &getName(int job) const;
+    float getTime(int job) const;
+
+private:
+    friend class JobSystem;
+    
+    struct Job
+    {
+        std::string name;
+        std::function<void()> work;
+        JobAffinity affinity;
+        
+        // Jobs waiting on this one, and how many jobs this one waits on
+        std::vector<int> dependents;
+        int dependencyCount;
+        
+        // Dependencies still running during a run, and the last run's timing
+        std::atomic<int> remaining;
+        double start, end;
+    };
+    
+    // A deque never moves its elements, which the atomics need
+    std::deque<Job> mJobs;
+};
+
+// Runs job graphs on a pool of worker threads
+// Every worker owns a deque: it pushes and pops jobs at the back, so dependents it releases run
+// next while their data is still in its cache, and idle workers steal from the front of other
+// workers' deques. The thread calling run takes part as well and is the only one that runs
+// JOB_MAIN jobs. Runs can be traced to a Chrome trace (chrome://tracing or Perfetto)
+class JobSystem
+{
+public:
+    // workers is the number of threads besides the calling one, by default one per remaining core
+    JobSystem(int workers = -1);
+    ~JobSystem();
+    
+    // Runs every job of the graph and returns once all of them finished
+    // Only one graph can run at a time
+    void run(JobGraph &graph);
+    
+    // Threads that run jobs, including the calling thread
+    unsigned int getThreadCount() const;
+    
+    // Records every job that runs from now on
+    void startTrace();
+    bool isTracing() const;
+    
+    // Writes the recorded jobs as a Chrome trace and stops recording, returns false if the file could not be written
+    bool writeTrace(const char* path);
+
+private:
+    // One thread's deque of job ids
+    struct WorkQueue
+    {
+        std::deque<int> jobs;
+        std::mutex mutex;
+    };
+    
+    // One finished job in the trace
+    struct TraceEvent
+    {
+        std::string name;
+        double start, end;
+        unsigned int thread;
+    };
+    
+    // Worker thread loop
+    void workerLoop(unsigned int thread);
+    
+    // Takes a job from the thread's own deque, or steals one from another thread, returns false if there was none
+    bool takeJob(unsigned int thread, int &job);
+    
+    // Queues a job whose dependencies have all finished
+    void schedule(int job, unsigned int thread);
+    
+    // Runs a job and releases its dependents
+    void execute(int job, unsigned int thread);
+    
+    // Wakes every sleeping thread
+    void wake();
+    
+    // Seconds since the job system was created
+    double now() const;
+    
+    // Deques of every thread (0 is the calling thread), and the JOB_MAIN queue
+    std::vector<std::unique_ptr<WorkQueue>> mQueues;
+    WorkQueue mMainQueue;
+    std::vector<std::thread> mThreads;
+    
+    // Graph being run, jobs queued in the deques and the main queue, and jobs not yet finished
+    JobGraph* mGraph;
+    std::atomic<int> mQueued, mMainQueued, mUnfinished;
+    
+    // Sleeping threads wait for queued jobs, the end of a run or shutdown
+    std::mutex mSleepMutex;
+    std::condition_variable mWake;
+    std::atomic<bool> mStopping;
+    
+    std::chrono::steady_clock::time_point mEpoch;
+    std::atomic<bool> mTracing;
+    std::mutex mTraceMutex;
+    std::vector<TraceEvent> mTrace;
+};
+
+#endif /* jobs_hpp */
@@ -0,0 +1,219 @@
+//
+//  lights.cpp
+//  SnakeGL
+//
+//  Created by Keegan Bilodeau on 10/19/26.
+//  Copyright © 2026 Keegan Bilodeau. All rights reserved.
+//
+
+#include "lights.hpp"
+#include "memory.hpp"
+
+#include <math.h>
+#include <float.h>
+#include <algorithm>
+
+LightManager::LightManager(int tileSize, int maxLights) : mTileSize(tileSize), mMaxLights(maxLights), mTilesX(0), mTilesY(0), mWidth(0), mHeight(0), mUploaded(false), mBuffers{0, 0, 0}, mTextures{0, 0, 0}
+{
+    mLights.reserve(maxLights);
+    MemoryRegistry::get().setCPU(this, MEMORY_LIGHTS, mLights.capacity() * sizeof(PointLight));
+}
+
+LightManager::~LightManager()
+{
+    MemoryRegistry::get().releaseCPU(this);
+    
+    if (mBuffers[0] == 0)
+        return;
+    
+    MemoryRegistry::get().destroyGL(GL_OBJECT_TEXTURE, mTextures, 3);
+    MemoryRegistry::get().destroyGL(GL_OBJECT_BUFFER, mBuffers, 3);
+    glDeleteTextures(3, mTextures);
+    glDeleteBuffers(3, mBuffers);
+}
+
+void LightManager::initGPU()
+{
+    glGenBuffers(3, mBuffers);
+    glGenTextures(3, mTextures);
+    MemoryRegistry::get().createGL(GL_OBJECT_BUFFER, mBuffers, 3, MEMORY_LIGHTS);
+    MemoryRegistry::get().createGL(GL_OBJECT_TEXTURE, mTextures, 3, MEMORY_LIGHTS);
+    
+    // Lights are two RGBA32F texels each, tile ranges one RG32UI texel and indices one R32UI texel
+    const GLenum formats[3] = {GL_RGBA32F, GL_RG32UI, GL_R32UI};
+    for (int i = 0; i < 3; i++)
+    {
+        // A texture buffer needs storage before it can be attached
+        glBindBuffer(GL_TEXTURE_BUFFER, mBuffers[i]);
+        glBufferData(GL_TEXTURE_BUFFER, 16, nullptr, GL_STREAM_DRAW);
+        MemoryRegistry::get().resizeGL(GL_OBJECT_BUFFER, mBuffers[i], 16);
+        
+        glBindTexture(GL_TEXTURE_BUFFER, mTextures[i]);
+        glTexBuffer(GL_TEXTURE_BUFFER, formats[i], mBuffers[i]);
+    }
+    
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void LightManager::clear()
+{
+    mLights.clear();
+}
+
+bool LightManager::addLight(const glm::vec3 &position, const glm::vec3 &color, float radius, float intensity)
+{
+    if ((int) mLights.size() >= mMaxLights)
+        return false;
+    
+    mLights.push_back(PointLight{position, radius, color, intensity});
+    
+    return true;
+}
+
+void LightManager::cull(const glm::mat4 &view, const glm::mat4 &projection, int width, int height)
+{
+    mWidth = width;
+    mHeight = height;
+    mTilesX = (width + mTileSize - 1) / mTileSize;
+    mTilesY = (height + mTileSize - 1) / mTileSize;
+    int tileCount = mTilesX * mTilesY;
+    
+    // First pass counts the lights touching every tile
+    mTileRanges.assign(tileCount * 2, 0);
+    mRects.resize(mLights.size());
+    for (size_t light = 0; light < mLights.size(); light++)
+    {
+        const TileRect &rect = mRects[light] = tileBounds(mLights[light], view, projection);
+        for (int y = rect.minY; y <= rect.maxY; y++)
+            for (int x = rect.minX; x <= rect.maxX; x++)
+                mTileRanges[(y * mTilesX + x) * 2 + 1]++;
+    }
+    
+    // Turns the counts into offsets into one shared index list
+    uint32_t offset = 0;
+    for (int tile = 0; tile < tileCount; tile++)
+    {
+        mTileRanges[tile * 2] = offset;
+        offset += mTileRanges[tile * 2 + 1];
+        mTileRanges[tile * 2 + 1] = 0;
+    }
+    
+    // Second pass writes every light into the lists of its tiles, counting them back up
+    mIndices.resize(offset);
+    for (size_t light = 0; light < mLights.size(); light++)
+    {
+        const TileRect &rect = mRects[light];
+        for (int y = rect.minY; y <= rect.maxY; y++)
+        {
+            for (int x = rect.minX; x <= rect.maxX; x++)
+            {
+                uint32_t* range = &mTileRanges[(y * mTilesX + x) * 2];
+                mIndices[range[0] + range[1]++] = (uint32_t) light;
+            }
+        }
+    }
+    
+    mUploaded = false;
+    
+    // The lists keep their capacity between frames, so this only grows when more lights or tiles show up
+    size_t bytes = mLights.capacity() * sizeof(PointLight) + mRects.capacity() * sizeof(TileRect) + (mTileRanges.capacity() + mIndices.capacity()) * sizeof(uint32_t);
+    MemoryRegistry::get().setCPU(this, MEMORY_LIGHTS, bytes);
+}
+
+void LightManager::bind(GLStateCache &cache)
+{
+    // The lists only change in cull, so binding for several programs uploads them once
+    if (!mUploaded && mBuffers[0] != 0)
+    {
+        // Position and radius, then color scaled by intensity
+        std::vector<glm::vec4> texels;
+        texels.reserve(mLights.size() * 2 + 1);
+        for (const PointLight &light : mLights)
+        {
+            texels.push_back(glm::vec4(light.position, light.radius));
+            texels.push_back(glm::vec4(light.color * light.intensity, 0.0f));
+        }
+        
+        // Buffers are never left empty, texture buffers without storage are not allowed
+        texels.push_back(glm::vec4(0.0f));
+        const void* data[3] = {texels.data(), mTileRanges.data(), mIndices.data()};
+        size_t sizes[3] = {texels.size() * sizeof(glm::vec4), mTileRanges.size() * sizeof(uint32_t), mIndices.size() * sizeof(uint32_t)};
+        
+        for (int i = 0; i < 3; i++)
+        {
+            // Orphans the old storage so the upload does not wait on last frame's draws
+            glBindBuffer(GL_TEXTURE_BUFFER, mBuffers[i]);
+            glBufferData(GL_TEXTURE_BUFFER, std::max(sizes[i], (size_t) 16), nullptr, GL_STREAM_DRAW);
+            MemoryRegistry::get().resizeGL(GL_OBJECT_BUFFER, mBuffers[i], std::max(sizes[i], (size_t) 16));
+            glBufferSubData(GL_TEXTURE_BUFFER, 0, sizes[i], data[i]);
+        }
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);
+        
+        mUploaded = true;
+    }
+    
+    cache.bindTexture(LIGHT_DATA_UNIT, mTextures[0], GL_TEXTURE_BUFFER);
+    cache.bindTexture(LIGHT_TILE_UNIT, mTextures[1], GL_TEXTURE_BUFFER);
+    cache.bindTexture(LIGHT_INDEX_UNIT, mTextures[2], GL_TEXTURE_BUFFER);
+    
+    cache.setUniform("lightData", (int) LIGHT_DATA_UNIT);
+    cache.setUniform("tileLights", (int) LIGHT_TILE_UNIT);
+    cache.setUniform("lightIndices", (int) LIGHT_INDEX_UNIT);
+    cache.setUniform("tileSize", mTileSize);
+    cache.setUniform("tilesX", mTilesX);
+}
+
+size_t LightManager::getLightCount() const
+{
+    return mLights.size();
+}
+
+int LightManager::getTileCount() const
+{
+    return mTilesX * mTilesY;
+}
+
+size_t LightManager::getEntryCount() const
+{
+    return mIndices.size();
+}
+
+LightManager::TileRect LightManager::tileBounds(const PointLight &light, const glm::mat4 &view, const glm::mat4 &projection) const
+{
+    const TileRect empty = {0, 0, -1, -1}, all = {0, 0, mTilesX - 1, mTilesY - 1};
+    
+    // The camera looks down -z in view space
+    glm::vec3 center = glm::vec3(view * glm::vec4(light.position, 1.0f));
+    float radius = light.radius;
+    if (center.z - radius >= 0.0f)
+        return empty;
+    
+    // A sphere reaching behind the camera can cover any part of the screen
+    if (center.z + radius >= -0.001f)
+        return all;
+    
+    // The projected corners of the sphere's view space box bound the sphere on screen
+    glm::vec2 low(FLT_MAX), high(-FLT_MAX);
+    for (int corner = 0; corner < 8; corner++)
+    {
+        glm::vec3 offset((corner & 1) ? radius : -radius, (corner & 2) ? radius : -radius, (corner & 4) ? radius : -radius);
+        glm::vec4 clip = projection * glm::vec4(center + offset, 1.0f);
+        glm::vec2 ndc = glm::vec2(clip) / clip.w;
+        low = glm::min(low, ndc);
+        high = glm::max(high, ndc);
+    }
+    
+    // Entirely outside the screen
+    if (low.x > 1.0f || low.y > 1.0f || high.x < -1.0f || high.y < -1.0f)
+        return empty;
+    
+    // Pixels run from the bottom left, just like gl_FragCoord
+    auto toTile = [&](float ndc, int pixels, int tiles) -> int
+    {
+        int tile = (int) floorf((ndc * 0.5f + 0.5f) * pixels / mTileSize);
+        return std::min(std::max(tile, 0), tiles - 1);
+    };
+    
+    return TileRect{toTile(low.x, mWidth, mTilesX), toTile(low.y, mHeight, mTilesY), toTile(high.x, mWidth, mTilesX), toTile(high.y, mHeight, mTilesY)};
+}
@@ -0,0 +1,88 @@
+//
+//  lights.hpp
+//  SnakeGL
+//
+//  Created by Keegan Bilodeau on 10/19/26.
+//  Copyright © 2026 Keegan Bilodeau. All rights reserved.
+//
+
+#ifndef lights_hpp
+#define lights_hpp
+
+#include <stdio.h>
+#include <stdint.h>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "renderqueue.hpp"
+
+// Texture units the light buffers are bound to, unit 0 is left for regular textures
+const unsigned int LIGHT_DATA_UNIT = 1, LIGHT_TILE_UNIT = 2, LIGHT_INDEX_UNIT = 3;
+
+// A point light whose influence fades to nothing at its radius
+struct PointLight
+{
+    glm::vec3 position;
+    float radius;
+    glm::vec3 color;
+    float intensity;
+};
+
+// Bins point lights into screen space tiles so that each fragment only evaluates the lights whose
+// bounds overlap its tile
+// Lights are added every frame, cull builds the per tile light lists on the CPU and bind uploads
+// them as texture buffers for the fragment shader
+class LightManager
+{
+public:
+    LightManager(int tileSize = 32, int maxLights = 1024);
+    ~LightManager();
+    
+    // Creates the texture buffers, needs a current GL context
+    void initGPU();
+    
+    // Removes every light, called at the start of a frame
+    void clear();
+    
+    // Adds a light for this frame, returns false once maxLights is reached
+    bool addLight(const glm::vec3 &position, const glm::vec3 &color, float radius, float intensity = 1.0f);
+    
+    // Projects every light's bounds to the screen and builds the light list of every tile
+    // width and height are the framebuffer size in pixels
+    void cull(const glm::mat4 &view, const glm::mat4 &projection, int width, int height);
+    
+    // Uploads the light lists and binds them for the program that is in use, along with the tiling uniforms
+    void bind(GLStateCache &cache);
+    
+    // Lights this frame, tiles on screen, and the total number of entries over all tile lists
+    size_t getLightCount() const;
+    int getTileCount() const;
+    size_t getEntryCount() const;
+
+private:
+    // Screen rectangle of tiles a light touches, empty if the light is off screen
+    struct TileRect
+    {
+        int minX, minY, maxX, maxY;
+    };
+    
+    // Finds the tiles a light's bounding sphere can cover
+    TileRect tileBounds(const PointLight &light, const glm::mat4 &view, const glm::mat4 &projection) const;
+    
+    int mTileSize, mMaxLights, mTilesX, mTilesY, mWidth, mHeight;
+    
+    // Set once this frame's lists are in the texture buffers
+    bool mUploaded;
+    
+    std::vector<PointLight> mLights;
+    std::vector<TileRect> mRects;
+    
+    // Per tile first entry and entry count, and the light indices of every tile back to back
+    std::vector<uint32_t> mTileRanges, mIndices;
+    
+    // Texture buffers (and their backing buffers) for the lights, tile ranges and indices
+    unsigned int mBuffers[3], mTextures[3];
+};
+
+#endif /* lights_hpp */
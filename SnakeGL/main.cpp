@@ -18,6 +18,7 @@
 #include <time.h>
 #include <vector>
 #include <filesystem>
+#include <string.h>
 
 // Window handler libraries
 #include <glad/glad.h>
@@ -34,8 +35,9 @@
 // Restores clang to its normal state
 #pragma clang diagnostic pop
 
-// Wrapper for openGL shaders
+// Wrapper for openGL shaders and their feature variants
 #include "shader.hpp"
+#include "shadervariants.hpp"
 
 // VAO generators for various shapes
 #include "renderable.hpp"
@@ -43,6 +45,43 @@
 // Contains the game's camera class
 #include "camera.hpp"
 
+// Sorted draw submission and GL state caching
+#include "renderqueue.hpp"
+
+// Game board and the autopilot that can steer the snake
+#include "board.hpp"
+#include "bot.hpp"
+
+// Command line benchmarks
+#include "benchmark.hpp"
+
+// Headless multiplayer server
+#include "server.hpp"
+
+// Flat game state and checkpoint files
+#include "snapshot.hpp"
+
+// Batched screen space text for the HUD
+#include "text.hpp"
+
+// Particle bursts for eating and dying
+#include "particles.hpp"
+
+// Tiled culling for the food and snake point lights
+#include "lights.hpp"
+
+// Adaptive render scale for the scene
+#include "resolution.hpp"
+
+// Smooth tube meshes for the snakes' bodies
+#include "snakemesh.hpp"
+
+// Runs each frame's work as a graph of jobs across all cores
+#include "jobs.hpp"
+
+// Byte counts of every GL object and of the larger CPU allocations
+#include "memory.hpp"
+
 // Game window
 GLFWwindow* window;
 
@@ -53,16 +92,37 @@ Camera camera(true);
 const float SCREEN_WIDTH = 750.0f;
 const float SCREEN_HEIGHT = 750.0f;
 
-// Time handling variables
-float deltaTime = 0.0f;
-float lastFrame = 0.0f;
 // Last x position of the cursor
 float lastX = 325, lastY = 325;
 // Keeps the screen from jerking on the first mouse input
 bool firstMouseInput = true;
 
-// Global light position
-glm::vec3 lightPos(1.2f, 1.0f, 2.0f);
+// Board dimensions, the size of a cell in world units, and the time between game ticks
+const int BOARD_WIDTH = 20, BOARD_HEIGHT = 20;
+const float CELL_SIZE = 0.1f, TICK_TIME = 0.15f;
+
+// The game board and the autopilot that can take over steering
+Board board(BOARD_WIDTH, BOARD_HEIGHT, (unsigned int) time(nullptr));
+BotController autopilot;
+
+// Timing and the player's snake, the camera part is only filled in when saving
+GameState game = {CameraState(), 0.0f, 0.0f, 0.0f, -1, false};
+
+// File used by quicksave and quickload
+const char* QUICKSAVE_PATH = "quicksave.snkc";
+
+// Particle effects, created once the GL context exists and freed before it goes away
+std::unique_ptr<ParticleSystem> particles;
+
+// Frame jobs, and the number of frames still to record when T starts a trace
+std::unique_ptr<JobSystem> jobs;
+int traceFrames = 0;
+const char* TRACE_PATH = "frames.trace.json";
+const int TRACE_FRAME_COUNT = 120;
+
+// Whether the memory overlay is shown (M), and where J dumps the registry
+bool showMemory = false;
+const char* MEMORY_DUMP_PATH = "memory.json";
 
 // Function predefinitions
 bool initWindow();
@@ -71,9 +131,22 @@ void framebuffer_size_callback(GLFWwindow* window, int width, int height);
 void key_callback(GLFWwindow* window, int key, int scancode, int action, int modes);
 void mouse_callback(GLFWwindow* window, double xPos, double yPos);
 void scroll_callback(GLFWwindow* window, double xOffset, double yOffset);
+void resetGame();
+void quicksave();
+void quickload();
+glm::vec3 cellPosition(int cell);
+std::string formatBytes(size_t bytes);
 
 int main(int argc, const char * argv[])
 {
+    // Runs a benchmark instead of the game when asked to
+    if (argc > 2 && strcmp(argv[1], "--bench") == 0)
+        return runBenchmark(argv[2]) ? EXIT_SUCCESS : EXIT_FAILURE;
+    
+    // Runs the arena without a window for clients to join over UDP
+    if (argc > 1 && strcmp(argv[1], "--server") == 0)
+        return runServer(argc > 2 ? (uint16_t) atoi(argv[2]) : NET_DEFAULT_PORT) ? EXIT_SUCCESS : EXIT_FAILURE;
+    
     // Initialize game window and check for failure
     if (!initWindow())
     {
@@ -84,49 +157,316 @@ int main(int argc, const char * argv[])
         return EXIT_FAILURE;
     }
     
-    // Creates a shader and sets it as the active shader
-    Shader shader("resources/vShader.vert", "resources/fShader.frag");
-    shader.use();
+    // Scene shader variants, each is compiled the first time a draw asks for its features
+    std::unique_ptr<ShaderVariants> sceneShaders(new ShaderVariants("resources/vShader.vert", "resources/fShader.frag"));
+    
+    // The key light stays where the camera started
+    glm::vec3 keyLightPos = camera.getCameraPos();
+    
+    // Bakes the HUD font, the game still runs without a HUD if it fails to load
+    std::unique_ptr<TextRenderer> hud(new TextRenderer());
+    hud->loadFont("resources/SourceCodePro-Regular.ttf", 20.0f);
+    int scoreText = hud->createText(), fpsText = hud->createText(), statusText = hud->createText(), scaleText = hud->createText();
+    // One overlay line per memory category and one for the totals
+    int memoryTexts[MEMORY_CATEGORY_COUNT + 1];
+    for (int &memoryText : memoryTexts)
+        memoryText = hud->createText();
+    
+    // Frames counted towards the next FPS update
+    int fpsFrames = 0;
+    float fpsTimer = 0.0f;
+    
+    // Particles fall back to CPU simulation if the GPU path is unavailable
+    particles.reset(new ParticleSystem());
+    particles->initGPU();
+    
+    // Scales the scene's resolution to keep its render time within 12 ms
+    std::unique_ptr<ResolutionScaler> resolution(new ResolutionScaler(12.0f));
+    resolution->initGPU();
+    
+    // Point lights are rebuilt every frame and binned into 32 pixel screen tiles
+    std::unique_ptr<LightManager> lights(new LightManager());
+    lights->initGPU();
+    
+    // Tracks bound GL state so that redundant binds and uniform uploads are skipped
+    GLStateCache stateCache;
+    // Collects the frame's draws so they can be sorted before submission, each with the scene variant it needs
+    RenderQueue renderQueue(*sceneShaders, 1000.0f);
+    
+    // Snake bodies are tubes rebuilt piece by piece as the snakes move
+    std::unique_ptr<SnakeMesher> bodyMesh(new SnakeMesher(CELL_SIZE, glm::vec3(-BOARD_WIDTH / 2.0f * CELL_SIZE, -BOARD_HEIGHT / 2.0f * CELL_SIZE, 0.0f)));
+    bodyMesh->initGPU();
+    // The tubes have no texture coordinates and are drawn as one mesh
+    const ShaderFeatures bodyFeatures = meshFeatures(false, false, true);
+    
+    // Cube meshes for the snake's head and food, drawn one at a time
+    const bool cubesTextured = false;
+    const ShaderFeatures cubeFeatures = meshFeatures(cubesTextured, false, true);
+    unsigned int headVAO, foodVAO;
+    generateCubeVAO(headVAO, CELL_SIZE * 0.5f, CELL_SIZE * 0.5f, 0.1f, 0.6f, 0.2f, cubesTextured);
+    generateCubeVAO(foodVAO, CELL_SIZE * 0.35f, CELL_SIZE * 0.35f, 0.9f, 0.2f, 0.2f, cubesTextured);
+    
+    // Starts the first game
+    resetGame();
     
-    // Sets uniforms neccessary for light calculations
-    shader.setUniform("lightColor", glm::vec3(1.0f, 1.0f, 1.0f));
-    shader.setUniform("lightPos", camera.getCameraPos());
+    // The board's state has a fixed size, restarts replace it with one just as large
+    MemoryRegistry::get().setCPU(&board, MEMORY_SIMULATION, board.getStateSize());
     
     // Created the matrixes for use in the main game loop
-    glm::mat4 model = glm::mat4(1.0f), view = glm::mat4(1.0f), projection = glm::mat4(1.0f);
+    glm::mat4 view = glm::mat4(1.0f), projection = glm::mat4(1.0f);
+    glm::vec3 cameraPos;
     
-    // Main game loop
-    while (!glfwWindowShouldClose(window))
+    // Sizes of the window's framebuffer and of the scene target this frame
+    int framebufferWidth = 0, framebufferHeight = 0, renderWidth = 0, renderHeight = 0;
+    // The HUD is laid out in window coordinates so that its text keeps the same size on high DPI screens
+    int windowWidth = (int) SCREEN_WIDTH, windowHeight = (int) SCREEN_HEIGHT;
+    
+    // One frame's work as a dependency graph, only jobs that touch the GL context stay on this thread
+    jobs.reset(new JobSystem());
+    JobGraph frame;
+    
+    int inputJob = frame.add("input", [&]()
     {
         float currentFrame = glfwGetTime();
-        deltaTime = currentFrame - lastFrame;
-        lastFrame = currentFrame;
+        game.deltaTime = currentFrame - game.lastFrame;
+        game.lastFrame = currentFrame;
         
         // Check for input once per frame (separate from window callback)
         processInput(window);
         
-        // Sets this shaders as the active shader
-        shader.use();
+        // The scene goes to a target sized to hold the frame budget, based on the real framebuffer which is
+        // larger than the window on high DPI screens
+        glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+        if (resolution->prepare(framebufferWidth, framebufferHeight))
+            stateCache.invalidate();
+        renderWidth = resolution->getRenderWidth();
+        renderHeight = resolution->getRenderHeight();
         
-        // Sets the model matrix uniform for the conversion from NDC to model coords
-        model = glm::mat4(1.0f);
-        shader.setUniform("model", model);
-        
-        // Sets the view matrix uniform for the conversion from model coords to view coords
+        // A minimized window has no size, the HUD keeps its last layout until it comes back
+        int width, height;
+        glfwGetWindowSize(window, &width, &height);
+        if (width > 0 && height > 0)
+        {
+            windowWidth = width;
+            windowHeight = height;
+        }
+    }, JOB_MAIN);
+    
+    int simulationJob = frame.add("simulation", [&]()
+    {
+        // Advances the game at a fixed rate, independent of the frame rate
+        game.tickTimer += game.deltaTime;
+        while (game.tickTimer >= TICK_TIME)
+        {
+            game.tickTimer -= TICK_TIME;
+            
+            // The autopilot only steers while it is switched on
+            autopilot.update(board);
+            
+            // Remembers the snake before the tick to spot it eating or dying
+            Snake before = board.getSnake(game.player);
+            board.tick();
+            const Snake &after = board.getSnake(game.player);
+            
+            if (after.score > before.score)
+                particles->emit(cellPosition(after.head), 400, glm::vec3(1.0f, 0.35f, 0.25f), 0.6f, 0.8f);
+            if (before.alive && !after.alive)
+                particles->emit(cellPosition(before.head), 4000, glm::vec3(0.3f, 0.9f, 0.35f), 1.2f, 1.5f);
+        }
+    });
+    
+    int cameraJob = frame.add("camera", [&]()
+    {
+        // Sets the view matrix for the conversion from model coords to view coords
         view = glm::mat4(1.0f);
         view = camera.getViewMatrix();
-        shader.setUniform("view", view);
+        cameraPos = camera.getCameraPos();
         
-        // Sets the projection matrix uniform for the conversion from view coords to projection coords
+        // Sets the projection matrix for the conversion from view coords to projection coords
         projection = glm::mat4(1.0f);
-        projection = glm::perspective(glm::radians(camera.getFOV()), SCREEN_WIDTH / SCREEN_HEIGHT, 0.1f, 1000.0f);
-        shader.setUniform("projection", projection);
+        projection = glm::perspective(glm::radians(camera.getFOV()), (float) renderWidth / renderHeight, 0.1f, 1000.0f);
+    });
+    
+    int particleJob = frame.add("particles", [&]()
+    {
+        particles->update(game.deltaTime);
+    });
+    
+    int lightJob = frame.add("lights", [&]()
+    {
+        // Food glows red, the head green, and every third body segment leaves a dimmer trail light
+        lights->clear();
+        glm::vec3 lightOffset(0.0f, 0.0f, CELL_SIZE);
+        for (int food = 0; food < board.getFoodCount(); food++)
+            lights->addLight(cellPosition(board.getFood()[food]) + lightOffset, glm::vec3(1.0f, 0.2f, 0.15f), CELL_SIZE * 3.5f, 1.5f);
+        for (int index = 0; index < board.getSnakeCount(); index++)
+        {
+            const Snake &lit = board.getSnake(index);
+            if (!lit.alive)
+                continue;
+            
+            lights->addLight(cellPosition(lit.head) + lightOffset, glm::vec3(0.3f, 1.0f, 0.35f), CELL_SIZE * 4.0f, 1.5f);
+            
+            // Body cells point towards the head, so the walk goes from the tail forwards
+            int segment = 0;
+            for (int cell = lit.tail; cell >= 0 && cell != lit.head; cell = board.getNeighbor(cell, (Direction) (board.getCell(cell) - CELL_BODY)), segment++)
+                if (segment % 3 == 0)
+                    lights->addLight(cellPosition(cell) + lightOffset, glm::vec3(0.2f, 0.8f, 0.3f), CELL_SIZE * 2.5f, 0.6f);
+        }
+        
+        // Bins the lights against the scene target, that is where gl_FragCoord is measured
+        lights->cull(view, projection, renderWidth, renderHeight);
+    });
+    
+    // Only the tube pieces next to a moved head or tail (or whose detail changed) are rebuilt, long
+    // rebuilds are shared out between one job per thread
+    bool bodyChanged = false;
+    int meshJob = frame.add("body mesh", [&]()
+    {
+        bodyChanged = bodyMesh->plan(board, cameraPos);
+    });
+    
+    std::vector<int> pieceJobs;
+    unsigned int pieceShares = jobs->getThreadCount();
+    for (unsigned int share = 0; share < pieceShares; share++)
+    {
+        pieceJobs.push_back(frame.add("body pieces", [&, share]()
+        {
+            bodyMesh->buildPieces(share, pieceShares);
+        }));
+    }
+    
+    int packJob = frame.add("body pack", [&]()
+    {
+        if (bodyChanged)
+            bodyMesh->pack();
+    });
+    
+    int drawListJob = frame.add("draw list", [&]()
+    {
+        // Queues a cube for every head and piece of food
+        for (int cell = 0; cell < BOARD_WIDTH * BOARD_HEIGHT; cell++)
+        {
+            uint8_t contents = board.getCell(cell);
+            if (contents != CELL_FOOD && contents != CELL_HEAD)
+                continue;
+            
+            unsigned int VAO = contents == CELL_FOOD ? foodVAO : headVAO;
+            glm::vec3 position = cellPosition(cell);
+            renderQueue.submit(PASS_OPAQUE, cubeFeatures, VAO, CUBE_INDEX_COUNT, glm::translate(glm::mat4(1.0f), position), glm::length(position - cameraPos));
+        }
+    });
+    
+    int hudJob = frame.add("hud", [&]()
+    {
+        // The FPS counter only changes twice a second, so its quads are reused in between
+        fpsFrames++;
+        fpsTimer += game.deltaTime;
+        if (fpsTimer >= 0.5f)
+        {
+            hud->setText(fpsText, std::to_string((int) (fpsFrames / fpsTimer + 0.5f)) + " FPS", windowWidth - 110.0f, 10.0f, glm::vec3(0.7f, 0.7f, 0.7f));
+            
+            // Render scale and the scene time against its budget
+            char scaleStats[64];
+            snprintf(scaleStats, sizeof(scaleStats), "%d%% %.1f/%.0f ms", (int) (resolution->getScale() * 100.0f + 0.5f), resolution->getSceneTime(), resolution->getBudget());
+            hud->setText(scaleText, scaleStats, windowWidth - 10.0f - hud->measure(scaleStats), 10.0f + hud->getLineHeight(), glm::vec3(0.7f, 0.7f, 0.7f));
+            fpsFrames = 0;
+            fpsTimer = 0.0f;
+            
+            // Live GPU and CPU bytes of every category, then the totals with their high-water marks
+            MemoryRegistry &registry = MemoryRegistry::get();
+            for (int category = 0; category <= MEMORY_CATEGORY_COUNT; category++)
+            {
+                std::string line;
+                if (category < MEMORY_CATEGORY_COUNT)
+                    line = std::string(MEMORY_CATEGORY_NAMES[category]) + " gpu " + formatBytes(registry.getGPU((MemoryCategory) category).bytes) + " cpu " + formatBytes(registry.getCPU((MemoryCategory) category).bytes);
+                else
+                    line = "total gpu " + formatBytes(registry.getGPUTotal().bytes) + " (peak " + formatBytes(registry.getGPUTotal().peak) + ") cpu " + formatBytes(registry.getCPUTotal().bytes) + " (peak " + formatBytes(registry.getCPUTotal().peak) + ")";
+                hud->setText(memoryTexts[category], line, 10.0f, 10.0f + (category + 3) * hud->getLineHeight(), glm::vec3(0.7f, 0.7f, 0.7f));
+            }
+        }
+        
+        for (int memoryText : memoryTexts)
+            hud->setVisible(memoryText, showMemory);
+        
+        // Score and status text are rebuilt only when they actually change
+        const Snake &snake = board.getSnake(game.player);
+        hud->setText(scoreText, "Score " + std::to_string(snake.score), 10.0f, 10.0f);
+        if (!snake.alive)
+            hud->setText(statusText, "Game over, press R to restart", 10.0f, 10.0f + hud->getLineHeight(), glm::vec3(0.9f, 0.3f, 0.3f));
+        else if (autopilot.isBot(game.player))
+            hud->setText(statusText, "Autopilot (P)", 10.0f, 10.0f + hud->getLineHeight(), glm::vec3(0.4f, 0.8f, 0.4f));
+        hud->setVisible(statusText, !snake.alive || autopilot.isBot(game.player));
+    });
+    
+    int submitJob = frame.add("gl submit", [&]()
+    {
+        resolution->begin();
+        
+        // The tubes were built on a worker, only their upload needs the context
+        bodyMesh->upload(stateCache);
+        if (bodyMesh->getIndexCount() > 0)
+            renderQueue.submit(PASS_OPAQUE, bodyFeatures, bodyMesh->getVAO(), bodyMesh->getIndexCount(), glm::mat4(1.0f), glm::length(cameraPos));
+        
+        // Variants first asked for this frame are compiled before the uniforms go out
+        renderQueue.prepareShaders();
+        
+        // Every scene variant in use gets the frame's uniforms, the cache skips the ones that did not change
+        for (Shader* variant : sceneShaders->getCompiled())
+        {
+            stateCache.useProgram(variant->ID);
+            stateCache.setUniform("view", view);
+            stateCache.setUniform("projection", projection);
+            stateCache.setUniform("lightColor", glm::vec3(1.0f, 1.0f, 1.0f));
+            stateCache.setUniform("lightPos", keyLightPos);
+            lights->bind(stateCache);
+        }
         
         // Clear the screen with a nice gray color
         glClearColor(0.138f, 0.138f, 0.138f, 1.0f);
         // Clear the color and depth buffers
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         
+        // Sorts the frame's draws and submits them through the state cache
+        renderQueue.flush(stateCache);
+        
+        // Particles are blended on top of the opaque cubes
+        particles->render(stateCache, view, projection);
+        
+        // Upscales the scene to the window, the HUD is drawn afterwards at full resolution
+        resolution->end();
+        
+        // All HUD text goes out in a single draw
+        hud->render(stateCache, windowWidth, windowHeight);
+    }, JOB_MAIN);
+    
+    // Everything waits on input, the per frame work waits on the tick and, where it needs them, the matrices
+    frame.depend(simulationJob, inputJob);
+    frame.depend(cameraJob, inputJob);
+    frame.depend(particleJob, simulationJob);
+    for (int job : {lightJob, meshJob, drawListJob})
+    {
+        frame.depend(job, simulationJob);
+        frame.depend(job, cameraJob);
+    }
+    for (int job : pieceJobs)
+    {
+        frame.depend(job, meshJob);
+        frame.depend(packJob, job);
+    }
+    frame.depend(hudJob, simulationJob);
+    for (int job : {particleJob, lightJob, packJob, drawListJob, hudJob})
+        frame.depend(submitJob, job);
+    
+    // Main game loop
+    while (!glfwWindowShouldClose(window))
+    {
+        jobs->run(frame);
+        
+        // Writes the trace once enough frames were recorded
+        if (jobs->isTracing() && --traceFrames <= 0)
+            jobs->writeTrace(TRACE_PATH);
+        
         // Swap the frame buffers
         glfwSwapBuffers(window);
         // Pump glfw's event queue
@@ -134,8 +474,25 @@ int main(int argc, const char * argv[])
     }
     
     // Free buffers
-    glDeleteProgram(shader.ID);
+    MemoryRegistry::get().destroyGL(GL_OBJECT_VERTEX_ARRAY, &headVAO, 1);
+    MemoryRegistry::get().destroyGL(GL_OBJECT_VERTEX_ARRAY, &foodVAO, 1);
+    glDeleteVertexArrays(1, &headVAO);
+    glDeleteVertexArrays(1, &foodVAO);
+    // The scene shaders, HUD, particles, lights, scene target and body mesh free their GL objects while the context still exists
+    sceneShaders.reset();
+    hud.reset();
+    particles.reset();
+    lights.reset();
+    resolution.reset();
+    bodyMesh.reset();
+    
+    // Stops the worker threads
+    jobs.reset();
     
+    // Everything created above has been destroyed by now, whatever is still registered leaked
+    MemoryRegistry::get().releaseCPU(&board);
+    if (MemoryRegistry::get().checkLeaks())
+        puts("No GL objects or tracked allocations leaked");
     
     // Shutdown GLFW
     glfwTerminate();
@@ -213,13 +570,13 @@ void processInput(GLFWwindow *window)
     
     // Processes keyboard input into directions used by the camera for movement
     if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
-        camera.processInput(FORWARD, deltaTime);
+        camera.processInput(FORWARD, game.deltaTime);
     if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
-        camera.processInput(BACKWARD, deltaTime);
+        camera.processInput(BACKWARD, game.deltaTime);
     if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
-        camera.processInput(LEFT, deltaTime);
+        camera.processInput(LEFT, game.deltaTime);
     if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
-        camera.processInput(RIGHT, deltaTime);
+        camera.processInput(RIGHT, game.deltaTime);
 }
 
 void framebuffer_size_callback(GLFWwindow *window, int width, int height)
@@ -233,7 +590,57 @@ void framebuffer_size_callback(GLFWwindow *window, int width, int height)
 
 void key_callback(GLFWwindow *window, int key, int scancode, int action, int modes)
 {
+    if (action != GLFW_PRESS)
+        return;
+    
+    // Arrow keys steer the snake unless the autopilot is driving
+    if (!autopilot.isBot(game.player))
+    {
+        if (key == GLFW_KEY_UP)
+            board.setDirection(game.player, NORTH);
+        else if (key == GLFW_KEY_DOWN)
+            board.setDirection(game.player, SOUTH);
+        else if (key == GLFW_KEY_LEFT)
+            board.setDirection(game.player, WEST);
+        else if (key == GLFW_KEY_RIGHT)
+            board.setDirection(game.player, EAST);
+    }
+    
+    // P toggles the autopilot
+    if (key == GLFW_KEY_P)
+    {
+        if (autopilot.isBot(game.player))
+            autopilot.removeBot(game.player);
+        else
+            autopilot.addBot(game.player);
+    }
     
+    // T records the job timings of the next frames to a Chrome trace
+    if (key == GLFW_KEY_T && !jobs->isTracing())
+    {
+        traceFrames = TRACE_FRAME_COUNT;
+        jobs->startTrace();
+    }
+    
+    // M shows the memory overlay and J writes every live resource to a JSON file
+    if (key == GLFW_KEY_M)
+        showMemory = !showMemory;
+    if (key == GLFW_KEY_J && MemoryRegistry::get().writeJSON(MEMORY_DUMP_PATH))
+        printf("Memory written to %s\n", MEMORY_DUMP_PATH);
+    
+    // G switches particle simulation between the CPU and the GPU
+    if (key == GLFW_KEY_G)
+        particles->setMode(particles->getMode() == PARTICLES_CPU ? PARTICLES_GPU : PARTICLES_CPU);
+    
+    // R starts a new game once the snake has died
+    if (key == GLFW_KEY_R && !board.getSnake(game.player).alive)
+        resetGame();
+    
+    // F5 saves the game and F9 loads it back
+    if (key == GLFW_KEY_F5)
+        quicksave();
+    else if (key == GLFW_KEY_F9)
+        quickload();
 }
 
 void mouse_callback(GLFWwindow *window, double xPos, double yPos)
@@ -265,3 +672,89 @@ void scroll_callback(GLFWwindow *window, double xOffset, double yOffset)
     // Pass the yOffset to the camera to allow for a zoom effect
     camera.processMouseScroll(yOffset);
 }
+
+void resetGame()
+{
+    // Keeps the autopilot switched on across restarts if it was driving
+    bool autopilotOn = game.player >= 0 && autopilot.isBot(game.player);
+    
+    // Fresh board with the snake in the middle heading north
+    board = Board(BOARD_WIDTH, BOARD_HEIGHT, (unsigned int) time(nullptr));
+    game.player = board.addSnake(BOARD_WIDTH / 2, BOARD_HEIGHT / 2, NORTH);
+    board.setFoodTarget(1);
+    
+    autopilot = BotController();
+    if (autopilotOn)
+        autopilot.addBot(game.player);
+    
+    game.tickTimer = 0.0f;
+}
+
+void quicksave()
+{
+    // Gathers the parts of the game that live outside the game state
+    game.camera = camera.getState();
+    game.autopilot = autopilot.isBot(game.player);
+    
+    if (CheckpointFile::save(QUICKSAVE_PATH, {game}, {&board}))
+        printf("Saved to %s\n", QUICKSAVE_PATH);
+}
+
+void quickload()
+{
+    CheckpointFile file;
+    Board loaded(BOARD_WIDTH, BOARD_HEIGHT);
+    if (!file.open(QUICKSAVE_PATH) || file.getCount() == 0 || !file.loadBoard(0, loaded))
+        return;
+    
+    // Drawing and the body mesh assume the board size the game was built with, and the player has to be one of the saved snakes
+    const GameState &saved = file.getGame(0);
+    if (loaded.getWidth() != BOARD_WIDTH || loaded.getHeight() != BOARD_HEIGHT || saved.player < 0 || saved.player >= loaded.getSnakeCount())
+    {
+        printf("ERROR::CHECKPOINT::INCOMPATIBLE_GAME\n%s\n", QUICKSAVE_PATH);
+        return;
+    }
+    
+    // The saved board can hold a different number of snakes and food, so its state size can differ
+    board = std::move(loaded);
+    MemoryRegistry::get().setCPU(&board, MEMORY_SIMULATION, board.getStateSize());
+    
+    // Keeps the frame clock running so the next frame does not see a huge delta time
+    float lastFrame = game.lastFrame;
+    game = saved;
+    game.lastFrame = lastFrame;
+    
+    camera.setState(game.camera);
+    
+    // Remembered paths belong to the old board
+    autopilot = BotController();
+    if (game.autopilot)
+        autopilot.addBot(game.player);
+}
+
+glm::vec3 cellPosition(int cell)
+{
+    // Centers the board on the origin, one cell per CELL_SIZE units
+    float x = (cell % BOARD_WIDTH - BOARD_WIDTH / 2.0f + 0.5f) * CELL_SIZE;
+    float y = (cell / BOARD_WIDTH - BOARD_HEIGHT / 2.0f + 0.5f) * CELL_SIZE;
+    
+    return glm::vec3(x, y, 0.0f);
+}
+
+std::string formatBytes(size_t bytes)
+{
+    // Picks the largest unit that keeps at least one whole unit
+    const char* units[4] = {"B", "KB", "MB", "GB"};
+    double value = (double) bytes;
+    int unit = 0;
+    while (value >= 1024.0 && unit < 3)
+    {
+        value /= 1024.0;
+        unit++;
+    }
+    
+    char text[32];
+    snprintf(text, sizeof(text), unit == 0 ? "%.0f %s" : "%.1f %s", value, units[unit]);
+    
+    return text;
+}
@@ -0,0 +1,199 @@
+//
+//  memory.cpp
+//  SnakeGL
+//
+//  Created by Keegan Bilodeau on 10/19/26.
+//  Copyright © 2026 Keegan Bilodeau. All rights reserved.
+//
+
+#include "memory.hpp"
+
+#include <string.h>
+#include <algorithm>
+
+// Registry key of a GL object
+static uint64_t objectKey(GLObjectType type, unsigned int id)
+{
+    return ((uint64_t) type << 32) | id;
+}
+
+MemoryRegistry &MemoryRegistry::get()
+{
+    static MemoryRegistry registry;
+    return registry;
+}
+
+MemoryRegistry::MemoryRegistry() : mGPUTotal{0, 0}, mCPUTotal{0, 0}
+{
+    memset(mObjectCounts, 0, sizeof(mObjectCounts));
+    memset(mGPU, 0, sizeof(mGPU));
+    memset(mCPU, 0, sizeof(mCPU));
+}
+
+void MemoryRegistry::createGL(GLObjectType type, const unsigned int* ids, int count, MemoryCategory category)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    
+    for (int i = 0; i < count; i++)
+    {
+        // A name GL handed out again was deleted without being destroyed here, so its old size goes
+        auto result = mObjects.insert({objectKey(type, ids[i]), Record{category, 0}});
+        if (!result.second)
+        {
+            adjust(mGPU, mGPUTotal, result.first->second.category, result.first->second.bytes, 0);
+            result.first->second = Record{category, 0};
+        }
+        else
+            mObjectCounts[type]++;
+    }
+}
+
+void MemoryRegistry::resizeGL(GLObjectType type, unsigned int id, size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    
+    auto object = mObjects.find(objectKey(type, id));
+    if (object == mObjects.end())
+        return;
+    
+    adjust(mGPU, mGPUTotal, object->second.category, object->second.bytes, bytes);
+    object->second.bytes = bytes;
+}
+
+void MemoryRegistry::destroyGL(GLObjectType type, const unsigned int* ids, int count)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    
+    for (int i = 0; i < count; i++)
+    {
+        auto object = mObjects.find(objectKey(type, ids[i]));
+        if (object == mObjects.end())
+            continue;
+        
+        adjust(mGPU, mGPUTotal, object->second.category, object->second.bytes, 0);
+        mObjects.erase(object);
+        mObjectCounts[type]--;
+    }
+}
+
+void MemoryRegistry::setCPU(const void* owner, MemoryCategory category, size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    
+    Record &record = mOwners.insert({owner, Record{category, 0}}).first->second;
+    adjust(mCPU, mCPUTotal, record.category, record.bytes, 0);
+    adjust(mCPU, mCPUTotal, category, 0, bytes);
+    record = Record{category, bytes};
+}
+
+void MemoryRegistry::releaseCPU(const void* owner)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    
+    auto record = mOwners.find(owner);
+    if (record == mOwners.end())
+        return;
+    
+    adjust(mCPU, mCPUTotal, record->second.category, record->second.bytes, 0);
+    mOwners.erase(record);
+}
+
+MemoryTotals MemoryRegistry::getGPU(MemoryCategory category) const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mGPU[category];
+}
+
+MemoryTotals MemoryRegistry::getCPU(MemoryCategory category) const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mCPU[category];
+}
+
+MemoryTotals MemoryRegistry::getGPUTotal() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mGPUTotal;
+}
+
+MemoryTotals MemoryRegistry::getCPUTotal() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mCPUTotal;
+}
+
+size_t MemoryRegistry::getObjectCount(GLObjectType type) const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mObjectCounts[type];
+}
+
+bool MemoryRegistry::writeJSON(const char* path) const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    
+    FILE* file = fopen(path, "w");
+    if (file == nullptr)
+    {
+        printf("ERROR::MEMORY::DUMP_NOT_WRITTEN\n%s\n", path);
+        return false;
+    }
+    
+    // Totals of one side of the bus, overall and per category
+    auto writeTotals = [&](const char* name, const MemoryTotals &total, const MemoryTotals* categories)
+    {
+        fprintf(file, "  \"%s\": {\"bytes\": %zu, \"peak\": %zu, \"categories\": {", name, total.bytes, total.peak);
+        for (int category = 0; category < MEMORY_CATEGORY_COUNT; category++)
+            fprintf(file, "%s\"%s\": {\"bytes\": %zu, \"peak\": %zu}", category > 0 ? ", " : "", MEMORY_CATEGORY_NAMES[category], categories[category].bytes, categories[category].peak);
+        fputs("}},\n", file);
+    };
+    
+    fputs("{\n", file);
+    writeTotals("gpu", mGPUTotal, mGPU);
+    writeTotals("cpu", mCPUTotal, mCPU);
+    
+    // Sorted so that dumps taken at different times can be diffed
+    std::vector<std::pair<uint64_t, Record>> objects(mObjects.begin(), mObjects.end());
+    std::sort(objects.begin(), objects.end(), [](const std::pair<uint64_t, Record> &a, const std::pair<uint64_t, Record> &b) { return a.first < b.first; });
+    
+    fputs("  \"objects\": [", file);
+    for (size_t i = 0; i < objects.size(); i++)
+        fprintf(file, "%s\n    {\"type\": \"%s\", \"id\": %u, \"category\": \"%s\", \"bytes\": %zu}", i > 0 ? "," : "", GL_OBJECT_TYPE_NAMES[objects[i].first >> 32], (unsigned int) objects[i].first, MEMORY_CATEGORY_NAMES[objects[i].second.category], objects[i].second.bytes);
+    fputs("\n  ],\n", file);
+    
+    fputs("  \"owners\": [", file);
+    size_t index = 0;
+    for (const auto &owner : mOwners)
+        fprintf(file, "%s\n    {\"address\": \"%p\", \"category\": \"%s\", \"bytes\": %zu}", index++ > 0 ? "," : "", owner.first, MEMORY_CATEGORY_NAMES[owner.second.category], owner.second.bytes);
+    fputs("\n  ]\n}\n", file);
+    
+    fclose(file);
+    
+    return true;
+}
+
+bool MemoryRegistry::checkLeaks() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    
+    for (const auto &object : mObjects)
+        printf("ERROR::MEMORY::GL_OBJECT_LEAKED\n%s %u (%s, %zu bytes)\n", GL_OBJECT_TYPE_NAMES[object.first >> 32], (unsigned int) object.first, MEMORY_CATEGORY_NAMES[object.second.category], object.second.bytes);
+    for (const auto &owner : mOwners)
+        printf("ERROR::MEMORY::CPU_OWNER_LEAKED\n%p (%s, %zu bytes)\n", owner.first, MEMORY_CATEGORY_NAMES[owner.second.category], owner.second.bytes);
+    
+    return mObjects.empty() && mOwners.empty();
+}
+
+size_t MemoryRegistry::textureBytes(int width, int height, int bytesPerPixel, bool mipmaps)
+{
+    size_t bytes = (size_t) width * height * bytesPerPixel;
+    return mipmaps ? bytes + bytes / 3 : bytes;
+}
+
+void MemoryRegistry::adjust(MemoryTotals* totals, MemoryTotals &total, MemoryCategory category, size_t oldBytes, size_t newBytes)
+{
+    totals[category].bytes = totals[category].bytes - oldBytes + newBytes;
+    totals[category].peak = std::max(totals[category].peak, totals[category].bytes);
+    total.bytes = total.bytes - oldBytes + newBytes;
+    total.peak = std::max(total.peak, total.bytes);
+}
@@ -0,0 +1,122 @@
+//
+//  memory.hpp
+//  SnakeGL
+//
+//  Created by Keegan Bilodeau on 10/19/26.
+//  Copyright © 2026 Keegan Bilodeau. All rights reserved.
+//
+
+#ifndef memory_hpp
+#define memory_hpp
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <mutex>
+#include <vector>
+#include <unordered_map>
+
+// Kinds of GL objects the registry keeps apart, object names are only unique within a kind
+enum GLObjectType
+{
+    GL_OBJECT_BUFFER,
+    GL_OBJECT_VERTEX_ARRAY,
+    GL_OBJECT_TEXTURE,
+    GL_OBJECT_RENDERBUFFER,
+    GL_OBJECT_FRAMEBUFFER,
+    GL_OBJECT_PROGRAM,
+    GL_OBJECT_QUERY,
+    GL_OBJECT_TYPE_COUNT
+};
+
+// What memory is used for, on either side of the bus
+enum MemoryCategory
+{
+    MEMORY_GEOMETRY,
+    MEMORY_TEXTURES,
+    MEMORY_RENDER_TARGETS,
+    MEMORY_SHADERS,
+    MEMORY_LIGHTS,
+    MEMORY_PARTICLES,
+    MEMORY_TEXT,
+    MEMORY_SIMULATION,
+    MEMORY_CATEGORY_COUNT
+};
+
+// Names used in the overlay and the JSON dump
+const char* const GL_OBJECT_TYPE_NAMES[GL_OBJECT_TYPE_COUNT] = {"buffer", "vertex_array", "texture", "renderbuffer", "framebuffer", "program", "query"};
+const char* const MEMORY_CATEGORY_NAMES[MEMORY_CATEGORY_COUNT] = {"geometry", "textures", "render_targets", "shaders", "lights", "particles", "text", "simulation"};
+
+// Live and peak byte counts
+struct MemoryTotals
+{
+    size_t bytes, peak;
+};
+
+// Records every GL object with the bytes it holds, and the CPU memory of every owner that reports it
+// Objects are added right after they are generated and removed right where they are deleted, so at
+// shutdown anything still registered was leaked. CPU owners report their current footprint whenever
+// it changes instead of every allocation. All functions can be called from any thread
+class MemoryRegistry
+{
+public:
+    // The process wide registry
+    static MemoryRegistry &get();
+    
+    // Registers freshly generated GL objects, they hold no memory until resized
+    void createGL(GLObjectType type, const unsigned int* ids, int count, MemoryCategory category);
+    
+    // Sets the bytes a GL object holds, for example after glBufferData or glTexImage2D
+    void resizeGL(GLObjectType type, unsigned int id, size_t bytes);
+    
+    // Forgets deleted GL objects, names that were never registered (like 0) are ignored
+    void destroyGL(GLObjectType type, const unsigned int* ids, int count);
+    
+    // Sets the CPU bytes an owner holds, registering it the first time
+    void setCPU(const void* owner, MemoryCategory category, size_t bytes);
+    
+    // Forgets an owner, call from its destructor
+    void releaseCPU(const void* owner);
+    
+    // Live and peak totals per category, or over every category
+    MemoryTotals getGPU(MemoryCategory category) const;
+    MemoryTotals getCPU(MemoryCategory category) const;
+    MemoryTotals getGPUTotal() const;
+    MemoryTotals getCPUTotal() const;
+    
+    // Number of live GL objects of one kind
+    size_t getObjectCount(GLObjectType type) const;
+    
+    // Writes the totals and every live object and owner as JSON, returns false if the file could not be written
+    bool writeJSON(const char* path) const;
+    
+    // Reports every GL object and CPU owner that is still registered, returns true if there were none
+    bool checkLeaks() const;
+    
+    // Bytes of a 2D texture, with the 1/3 extra of a full mipmap chain if it has one
+    static size_t textureBytes(int width, int height, int bytesPerPixel, bool mipmaps = false);
+
+private:
+    MemoryRegistry();
+    
+    struct Record
+    {
+        MemoryCategory category;
+        size_t bytes;
+    };
+    
+    // Moves a category's live bytes and updates the peaks
+    void adjust(MemoryTotals* totals, MemoryTotals &total, MemoryCategory category, size_t oldBytes, size_t newBytes);
+    
+    // GL objects keyed by type and name, and CPU owners
+    std::unordered_map<uint64_t, Record> mObjects;
+    std::unordered_map<const void*, Record> mOwners;
+    size_t mObjectCounts[GL_OBJECT_TYPE_COUNT];
+    
+    MemoryTotals mGPU[MEMORY_CATEGORY_COUNT], mCPU[MEMORY_CATEGORY_COUNT];
+    MemoryTotals mGPUTotal, mCPUTotal;
+    
+    mutable std::mutex mMutex;
+};
+
+#endif /* memory_hpp */
@@ -0,0 +1,271 @@
+//
+//  net.cpp
+//  SnakeGL
+//
+//  Created by Keegan Bilodeau on 10/19/26.
+//  Copyright © 2026 Keegan Bilodeau. All rights reserved.
+//
+
+#include "net.hpp"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+bool NetAddress::operator==(const NetAddress &other) const
+{
+    return host == other.host && port == other.port;
+}
+
+NetAddress loopbackAddress(uint16_t port)
+{
+    return NetAddress{INADDR_LOOPBACK, port};
+}
+
+UdpSocket::UdpSocket() : mSocket(-1)
+{
+}
+
+UdpSocket::~UdpSocket()
+{
+    close();
+}
+
+bool UdpSocket::open(uint16_t port)
+{
+    close();
+    
+    mSocket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (mSocket < 0)
+    {
+        printf("ERROR::NET::SOCKET_NOT_CREATED\n%s\n", strerror(errno));
+        return false;
+    }
+    
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+    
+    if (bind(mSocket, (const sockaddr*) &address, sizeof(address)) < 0)
+    {
+        printf("ERROR::NET::SOCKET_NOT_BOUND\nport %u: %s\n", port, strerror(errno));
+        close();
+        return false;
+    }
+    
+    // Reads return straight away when nothing is waiting, the game and server loops poll
+    fcntl(mSocket, F_SETFL, fcntl(mSocket, F_GETFL, 0) | O_NONBLOCK);
+    
+    // Many clients on one server can burst past the default receive buffer
+    int bufferSize = 1 << 20;
+    setsockopt(mSocket, SOL_SOCKET, SO_RCVBUF, &bufferSize, sizeof(bufferSize));
+    setsockopt(mSocket, SOL_SOCKET, SO_SNDBUF, &bufferSize, sizeof(bufferSize));
+    
+    return true;
+}
+
+void UdpSocket::close()
+{
+    if (mSocket < 0)
+        return;
+    
+    ::close(mSocket);
+    mSocket = -1;
+}
+
+bool UdpSocket::isOpen() const
+{
+    return mSocket >= 0;
+}
+
+bool UdpSocket::send(const NetAddress &address, const void* data, size_t size)
+{
+    sockaddr_in destination;
+    memset(&destination, 0, sizeof(destination));
+    destination.sin_family = AF_INET;
+    destination.sin_addr.s_addr = htonl(address.host);
+    destination.sin_port = htons(address.port);
+    
+    return sendto(mSocket, data, size, 0, (const sockaddr*) &destination, sizeof(destination)) == (ssize_t) size;
+}
+
+int UdpSocket::receive(NetAddress &address, void* data, size_t capacity)
+{
+    sockaddr_in source;
+    socklen_t sourceSize = sizeof(source);
+    ssize_t size = recvfrom(mSocket, data, capacity, 0, (sockaddr*) &source, &sourceSize);
+    if (size < 0)
+        return -1;
+    
+    address.host = ntohl(source.sin_addr.s_addr);
+    address.port = ntohs(source.sin_port);
+    
+    return (int) size;
+}
+
+uint16_t UdpSocket::getPort() const
+{
+    sockaddr_in address;
+    socklen_t size = sizeof(address);
+    if (mSocket < 0 || getsockname(mSocket, (sockaddr*) &address, &size) < 0)
+        return 0;
+    
+    return ntohs(address.sin_port);
+}
+
+BitWriter::BitWriter() : mBits(0)
+{
+}
+
+void BitWriter::write(uint32_t value, int bits)
+{
+    // Bits go into each byte from the lowest up
+    for (int i = 0; i < bits; i++)
+    {
+        if (mBits % 8 == 0)
+            mData.push_back(0);
+        
+        mData.back() |= ((value >> i) & 1) << (mBits % 8);
+        mBits++;
+    }
+}
+
+void BitWriter::writeGamma(uint32_t value)
+{
+    // As many zeros as the value has bits after its highest one, then a one, then those bits
+    int length = 31 - __builtin_clz(value);
+    write(0, length);
+    write(1, 1);
+    write(value, length);
+}
+
+void BitWriter::clear()
+{
+    mData.clear();
+    mBits = 0;
+}
+
+const uint8_t* BitWriter::getData() const
+{
+    return mData.data();
+}
+
+size_t BitWriter::getSize() const
+{
+    return mData.size();
+}
+
+size_t BitWriter::getBits() const
+{
+    return mBits;
+}
+
+BitReader::BitReader(const uint8_t* data, size_t size) : mData(data), mSize(size), mBit(0), mOverflowed(false)
+{
+}
+
+uint32_t BitReader::read(int bits)
+{
+    uint32_t value = 0;
+    for (int i = 0; i < bits; i++)
+    {
+        if (mBit >= mSize * 8)
+        {
+            mOverflowed = true;
+            return 0;
+        }
+        
+        value |= (uint32_t) ((mData[mBit / 8] >> (mBit % 8)) & 1) << i;
+        mBit++;
+    }
+    
+    return value;
+}
+
+uint32_t BitReader::readGamma()
+{
+    // Counts the leading zeros, a well formed value never has more than 31
+    int length = 0;
+    while (read(1) == 0)
+    {
+        if (mOverflowed || ++length > 31)
+        {
+            mOverflowed = true;
+            return 1;
+        }
+    }
+    
+    return (1u << length) | read(length);
+}
+
+bool BitReader::overflowed() const
+{
+    return mOverflowed;
+}
+
+uint8_t NetView::getCell(int cellX, int cellY) const
+{
+    if (cellX < x || cellY < y || cellX >= x + width || cellY >= y + height)
+        return CELL_EMPTY;
+    
+    return cells[(cellY - y) * width + (cellX - x)];
+}
+
+void writeViewDelta(BitWriter &writer, const NetView* baseline, const NetView &view)
+{
+    // Finds every cell that differs from what the client already has, cells that just came into
+    // the window count as empty on both sides
+    std::vector<uint32_t> changes;
+    for (int row = 0; row < view.height; row++)
+    {
+        for (int column = 0; column < view.width; column++)
+        {
+            int index = row * view.width + column;
+            uint8_t known = baseline ? baseline->getCell(view.x + column, view.y + row) : (uint8_t) CELL_EMPTY;
+            if (view.cells[index] != known)
+                changes.push_back((uint32_t) index);
+        }
+    }
+    
+    // Snakes only change the board at their heads and tails, so changes are few and far apart
+    writer.writeGamma((uint32_t) changes.size() + 1);
+    uint32_t next = 0;
+    for (uint32_t index : changes)
+    {
+        writer.writeGamma(index - next + 1);
+        writer.write(view.cells[index], NET_CELL_BITS);
+        next = index + 1;
+    }
+}
+
+bool readViewDelta(BitReader &reader, const NetView* baseline, NetView &view)
+{
+    // Starts from the baseline's cells inside the new window
+    view.cells.resize(view.width * view.height);
+    for (int row = 0; row < view.height; row++)
+        for (int column = 0; column < view.width; column++)
+            view.cells[row * view.width + column] = baseline ? baseline->getCell(view.x + column, view.y + row) : (uint8_t) CELL_EMPTY;
+    
+    uint32_t count = reader.readGamma() - 1, next = 0;
+    if (count > view.cells.size())
+        return false;
+    
+    for (uint32_t i = 0; i < count && !reader.overflowed(); i++)
+    {
+        uint32_t index = next + reader.readGamma() - 1;
+        uint8_t cell = (uint8_t) reader.read(NET_CELL_BITS);
+        if (index >= view.cells.size() || cell > CELL_HEAD)
+            return false;
+        
+        view.cells[index] = cell;
+        next = index + 1;
+    }
+    
+    return !reader.overflowed();
+}
@@ -0,0 +1,169 @@
+//
+//  net.hpp
+//  SnakeGL
+//
+//  Created by Keegan Bilodeau on 10/19/26.
+//  Copyright © 2026 Keegan Bilodeau. All rights reserved.
+//
+
+#ifndef net_hpp
+#define net_hpp
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+#include "board.hpp"
+
+// Port the server listens on unless told otherwise
+const uint16_t NET_DEFAULT_PORT = 27960;
+
+// Starts every packet, anything else arriving on the port is dropped
+const uint32_t NET_PROTOCOL_ID = 0x534E4B31;
+
+// Largest packet either side sends, small enough to never be fragmented
+const size_t NET_MAX_PACKET = 1200;
+
+// Cells around a snake's head that its client is sent, a window of (2 * radius + 1) cells on a side
+const int NET_INTEREST_RADIUS = 8;
+
+// Snapshots both sides remember, an acknowledged snapshot older than this can no longer be a baseline
+const int NET_HISTORY_SIZE = 32;
+
+// Bits used for a cell's contents, every CellType fits
+const int NET_CELL_BITS = 3;
+
+// What a packet carries, sent in the packet header
+enum PacketType
+{
+    PACKET_CONNECT,
+    PACKET_INPUT,
+    PACKET_DISCONNECT,
+    PACKET_WELCOME,
+    PACKET_REJECT,
+    PACKET_SNAPSHOT
+};
+
+// Bits used for the packet type
+const int NET_TYPE_BITS = 3;
+
+// IPv4 address and port of a peer, both in host byte order
+struct NetAddress
+{
+    uint32_t host;
+    uint16_t port;
+    
+    bool operator==(const NetAddress &other) const;
+};
+
+// Address on this machine, for servers and clients tested over loopback
+NetAddress loopbackAddress(uint16_t port);
+
+// Non-blocking UDP socket
+class UdpSocket
+{
+public:
+    UdpSocket();
+    ~UdpSocket();
+    
+    UdpSocket(const UdpSocket &) = delete;
+    UdpSocket &operator=(const UdpSocket &) = delete;
+    
+    // Binds to the port on every interface, 0 picks any free port, returns false if the socket could not be opened
+    bool open(uint16_t port = 0);
+    void close();
+    bool isOpen() const;
+    
+    // Sends one datagram, returns false if it could not be handed to the network
+    bool send(const NetAddress &address, const void* data, size_t size);
+    
+    // Reads one waiting datagram, returns its size or -1 if nothing is waiting
+    int receive(NetAddress &address, void* data, size_t capacity);
+    
+    // Port the socket is bound to
+    uint16_t getPort() const;
+
+private:
+    int mSocket;
+};
+
+// Packs values into a byte buffer with no padding between them
+class BitWriter
+{
+public:
+    BitWriter();
+    
+    // Appends the low bits of a value, up to 32 bits
+    void write(uint32_t value, int bits);
+    
+    // Appends a value of at least 1 in Elias gamma code, small values take few bits
+    void writeGamma(uint32_t value);
+    
+    // Starts over with an empty buffer, keeping its capacity
+    void clear();
+    
+    // Written bytes, the last one padded with zero bits
+    const uint8_t* getData() const;
+    size_t getSize() const;
+    size_t getBits() const;
+
+private:
+    std::vector<uint8_t> mData;
+    size_t mBits;
+};
+
+// Reads values back in the order a BitWriter wrote them
+class BitReader
+{
+public:
+    BitReader(const uint8_t* data, size_t size);
+    
+    // Reads a value of up to 32 bits, reading past the end returns zeros and marks the reader as overflowed
+    uint32_t read(int bits);
+    
+    // Reads a value written with writeGamma
+    uint32_t readGamma();
+    
+    // True once a read went past the end of the data, anything read since is garbage
+    bool overflowed() const;
+
+private:
+    const uint8_t* mData;
+    size_t mSize, mBit;
+    bool mOverflowed;
+};
+
+// The part of a board one client knows about after a snapshot, a window of cells around its snake
+struct NetView
+{
+    // Board tick the view was taken at, 0 marks an empty history slot
+    uint32_t tick = 0;
+    
+    // Window position and size in cells, clipped to the board
+    int x = 0, y = 0, width = 0, height = 0;
+    
+    // Window cells row by row
+    std::vector<uint8_t> cells;
+    
+    // Contents of a board cell, cells outside the window read as empty
+    uint8_t getCell(int cellX, int cellY) const;
+};
+
+// A client's own snake, sent with every snapshot
+struct NetSnakeState
+{
+    bool alive;
+    int headX, headY;
+    Direction direction;
+    unsigned int score, length;
+};
+
+// Writes the cells of a view as changes against a baseline view, without a baseline every non-empty cell is a change
+// Every change is the gamma coded number of unchanged cells before it and the new contents
+void writeViewDelta(BitWriter &writer, const NetView* baseline, const NetView &view);
+
+// Reads the changes written by writeViewDelta into a view whose window is already set, returns false if the data was cut short
+bool readViewDelta(BitReader &reader, const NetView* baseline, NetView &view);
+
+#endif /* net_hpp */
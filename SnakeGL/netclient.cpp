@@ -0,0 +1,245 @@
+//
+//  netclient.cpp
+//  SnakeGL
+//
+//  Created by Keegan Bilodeau on 10/19/26.
+//  Copyright © 2026 Keegan Bilodeau. All rights reserved.
+//
+
+#include "netclient.hpp"
+
+#include <chrono>
+#include <utility>
+
+// Seconds on a monotonic clock
+static double now()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+NetClient::NetClient() : bytesSent(0), bytesReceived(0), snapshotsReceived(0), snapshotsDropped(0), simulatedLoss(0.0f), mServer{0, 0}, mConnected(false), mRejected(false), mLastConnect(0.0), mBoardWidth(0), mBoardHeight(0), mTickTime(0.0f), mLatestTick(0), mSnake{false, 0, 0, NORTH, 0, 0}, mSeed(2463534242u)
+{
+}
+
+NetClient::~NetClient()
+{
+    disconnect();
+}
+
+bool NetClient::connect(const NetAddress &server)
+{
+    disconnect();
+    
+    if (!mSocket.open())
+        return false;
+    
+    mServer = server;
+    mRejected = false;
+    mLatestTick = 0;
+    for (NetView &view : mHistory)
+        view.tick = 0;
+    
+    // Every client gets its own loss pattern
+    mSeed = 2463534242u ^ mSocket.getPort();
+    
+    sendHeader(PACKET_CONNECT);
+    mLastConnect = now();
+    
+    return true;
+}
+
+void NetClient::disconnect()
+{
+    if (!mSocket.isOpen())
+        return;
+    
+    if (mConnected)
+        sendHeader(PACKET_DISCONNECT);
+    
+    mSocket.close();
+    mConnected = false;
+}
+
+bool NetClient::update()
+{
+    if (!mSocket.isOpen())
+        return false;
+    
+    // Connect requests and welcomes can be lost like any other packet
+    if (!mConnected && !mRejected && now() - mLastConnect > NET_CONNECT_RETRY)
+    {
+        sendHeader(PACKET_CONNECT);
+        mLastConnect = now();
+    }
+    
+    uint32_t previous = mLatestTick;
+    uint8_t packet[NET_MAX_PACKET];
+    NetAddress address;
+    
+    int size;
+    while ((size = mSocket.receive(address, packet, sizeof(packet))) >= 0)
+    {
+        if (!(address == mServer))
+            continue;
+        
+        if (simulatedLoss > 0.0f)
+        {
+            mSeed ^= mSeed << 13;
+            mSeed ^= mSeed >> 17;
+            mSeed ^= mSeed << 5;
+            if ((mSeed & 0xFFFF) < simulatedLoss * 65536.0f)
+                continue;
+        }
+        
+        bytesReceived += size;
+        handlePacket(packet, size);
+    }
+    
+    return mLatestTick != previous;
+}
+
+void NetClient::sendInput()
+{
+    mWriter.clear();
+    mWriter.write(NET_PROTOCOL_ID, 32);
+    mWriter.write(PACKET_INPUT, NET_TYPE_BITS);
+    mWriter.write(mLatestTick, 32);
+    mWriter.write(0, 3);
+    mSocket.send(mServer, mWriter.getData(), mWriter.getSize());
+    bytesSent += mWriter.getSize();
+}
+
+void NetClient::sendInput(Direction direction)
+{
+    mWriter.clear();
+    mWriter.write(NET_PROTOCOL_ID, 32);
+    mWriter.write(PACKET_INPUT, NET_TYPE_BITS);
+    mWriter.write(mLatestTick, 32);
+    mWriter.write(1, 1);
+    mWriter.write(direction, 2);
+    mSocket.send(mServer, mWriter.getData(), mWriter.getSize());
+    bytesSent += mWriter.getSize();
+}
+
+bool NetClient::isConnected() const
+{
+    return mConnected;
+}
+
+bool NetClient::wasRejected() const
+{
+    return mRejected;
+}
+
+int NetClient::getBoardWidth() const
+{
+    return mBoardWidth;
+}
+
+int NetClient::getBoardHeight() const
+{
+    return mBoardHeight;
+}
+
+float NetClient::getTickTime() const
+{
+    return mTickTime;
+}
+
+const NetView &NetClient::getView() const
+{
+    return mHistory[mLatestTick % NET_HISTORY_SIZE];
+}
+
+const NetSnakeState &NetClient::getSnake() const
+{
+    return mSnake;
+}
+
+void NetClient::handlePacket(const uint8_t* data, size_t size)
+{
+    BitReader reader(data, size);
+    if (reader.read(32) != NET_PROTOCOL_ID)
+        return;
+    
+    PacketType type = (PacketType) reader.read(NET_TYPE_BITS);
+    
+    if (type == PACKET_WELCOME)
+    {
+        mBoardWidth = reader.read(16);
+        mBoardHeight = reader.read(16);
+        mTickTime = reader.read(16) / 1000.0f;
+        mConnected = !reader.overflowed();
+        return;
+    }
+    
+    if (type == PACKET_REJECT)
+    {
+        mRejected = true;
+        return;
+    }
+    
+    if (type == PACKET_DISCONNECT)
+    {
+        mConnected = false;
+        return;
+    }
+    
+    if (type != PACKET_SNAPSHOT || !mConnected)
+        return;
+    
+    // Late packets are older than what the client already shows
+    uint32_t tick = reader.read(32), baselineTick = reader.read(32);
+    if (reader.overflowed() || tick <= mLatestTick)
+        return;
+    
+    // The baseline has to be one of the snapshots still remembered here
+    const NetView* baseline = nullptr;
+    if (baselineTick != 0)
+    {
+        baseline = &mHistory[baselineTick % NET_HISTORY_SIZE];
+        if (baseline->tick != baselineTick)
+        {
+            snapshotsDropped++;
+            return;
+        }
+    }
+    
+    mDecoded.tick = tick;
+    mDecoded.x = reader.read(16);
+    mDecoded.y = reader.read(16);
+    mDecoded.width = reader.read(8);
+    mDecoded.height = reader.read(8);
+    
+    NetSnakeState snake = {false, 0, 0, NORTH, 0, 0};
+    snake.alive = reader.read(1);
+    if (snake.alive)
+    {
+        snake.headX = reader.read(16);
+        snake.headY = reader.read(16);
+        snake.direction = (Direction) reader.read(2);
+        snake.score = reader.readGamma() - 1;
+        snake.length = reader.readGamma();
+    }
+    
+    if (reader.overflowed() || !readViewDelta(reader, baseline, mDecoded))
+    {
+        snapshotsDropped++;
+        return;
+    }
+    
+    // The decoded view takes over the oldest slot, keeping the old cells' storage for the next decode
+    std::swap(mHistory[tick % NET_HISTORY_SIZE], mDecoded);
+    mLatestTick = tick;
+    mSnake = snake;
+    snapshotsReceived++;
+}
+
+void NetClient::sendHeader(PacketType type)
+{
+    mWriter.clear();
+    mWriter.write(NET_PROTOCOL_ID, 32);
+    mWriter.write(type, NET_TYPE_BITS);
+    mSocket.send(mServer, mWriter.getData(), mWriter.getSize());
+    bytesSent += mWriter.getSize();
+}
@@ -0,0 +1,88 @@
+//
+//  netclient.hpp
+//  SnakeGL
+//
+//  Created by Keegan Bilodeau on 10/19/26.
+//  Copyright © 2026 Keegan Bilodeau. All rights reserved.
+//
+
+#ifndef netclient_hpp
+#define netclient_hpp
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "net.hpp"
+
+// Seconds between connect requests while the server has not answered
+const double NET_CONNECT_RETRY = 0.5;
+
+// Player connection to a GameServer
+// Rebuilds the cells around its snake from the server's delta snapshots, and acknowledges every
+// snapshot it decodes so the server can use it as the baseline for the next ones
+class NetClient
+{
+public:
+    NetClient();
+    ~NetClient();
+    
+    // Opens a socket and asks the server for a slot, update repeats the request until the server answers
+    bool connect(const NetAddress &server);
+    
+    // Tells the server the player left and closes the socket
+    void disconnect();
+    
+    // Reads every waiting packet, returns true if a newer snapshot was decoded
+    bool update();
+    
+    // Acknowledges the newest snapshot, optionally turning the snake as well
+    void sendInput();
+    void sendInput(Direction direction);
+    
+    // Whether the server accepted the player, or turned it away because it was full
+    bool isConnected() const;
+    bool wasRejected() const;
+    
+    // Arena size and tick length the server sent when accepting the player
+    int getBoardWidth() const;
+    int getBoardHeight() const;
+    float getTickTime() const;
+    
+    // Newest decoded snapshot, its view of the board and the player's own snake
+    const NetView &getView() const;
+    const NetSnakeState &getSnake() const;
+    
+    // Traffic, decoded snapshots, and snapshots dropped because their baseline was not remembered
+    uint64_t bytesSent, bytesReceived, snapshotsReceived, snapshotsDropped;
+    
+    // Share of incoming packets thrown away on purpose, to test recovery from packet loss
+    float simulatedLoss;
+
+private:
+    // Handles one packet from the server
+    void handlePacket(const uint8_t* data, size_t size);
+    
+    // Sends a packet that only has a header
+    void sendHeader(PacketType type);
+    
+    UdpSocket mSocket;
+    NetAddress mServer;
+    bool mConnected, mRejected;
+    double mLastConnect;
+    
+    int mBoardWidth, mBoardHeight;
+    float mTickTime;
+    
+    // Decoded snapshots by tick, the newest one's tick, and the snake sent with it
+    NetView mHistory[NET_HISTORY_SIZE];
+    NetView mDecoded;
+    uint32_t mLatestTick;
+    NetSnakeState mSnake;
+    
+    // Random numbers for the simulated loss
+    uint32_t mSeed;
+    
+    BitWriter mWriter;
+};
+
+#endif /* netclient_hpp */
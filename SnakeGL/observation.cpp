@@ -0,0 +1,286 @@
+//
+//  observation.cpp
+//  SnakeGL
+//
+//  Created by Keegan Bilodeau on 10/19/26.
+//  Copyright © 2026 Keegan Bilodeau. All rights reserved.
+//
+
+#include "observation.hpp"
+
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#include "memory.hpp"
+#include "renderable.hpp"
+
+// Palette index of a cell's contents
+static int paletteIndex(uint8_t cell)
+{
+    if (cell == CELL_EMPTY)
+        return 0;
+    if (cell == CELL_FOOD)
+        return 1;
+    
+    return cell == CELL_HEAD ? 3 : 2;
+}
+
+// Fills count pixels with one color, four pixels per store where SIMD is available
+static inline void fillSpan(uint32_t* pixels, int count, uint32_t color)
+{
+    int i = 0;
+
+#if defined(__SSE2__)
+    __m128i wide = _mm_set1_epi32((int) color);
+    for (; i + 4 <= count; i += 4)
+        _mm_storeu_si128((__m128i*) (pixels + i), wide);
+#elif defined(__ARM_NEON)
+    uint32x4_t wide = vdupq_n_u32(color);
+    for (; i + 4 <= count; i += 4)
+        vst1q_u32(pixels + i, wide);
+#endif
+    
+    for (; i < count; i++)
+        pixels[i] = color;
+}
+
+ObservationRenderer::ObservationRenderer(int tileSize) : mTileSize(tileSize), mMaxBoards(0), mAtlasColumns(0), mAtlasRows(0), mFramebuffer(0), mColorTexture(0), mQuadVAO(0), mInstanceVBO(0), mEdgeWidth(0), mEdgeHeight(0)
+{
+}
+
+ObservationRenderer::~ObservationRenderer()
+{
+    // Only the GPU path owns GL objects
+    if (mFramebuffer == 0)
+        return;
+    
+    MemoryRegistry &registry = MemoryRegistry::get();
+    registry.destroyGL(GL_OBJECT_FRAMEBUFFER, &mFramebuffer, 1);
+    registry.destroyGL(GL_OBJECT_TEXTURE, &mColorTexture, 1);
+    registry.destroyGL(GL_OBJECT_VERTEX_ARRAY, &mQuadVAO, 1);
+    registry.destroyGL(GL_OBJECT_BUFFER, &mInstanceVBO, 1);
+    glDeleteFramebuffers(1, &mFramebuffer);
+    glDeleteTextures(1, &mColorTexture);
+    glDeleteVertexArrays(1, &mQuadVAO);
+    glDeleteBuffers(1, &mInstanceVBO);
+    
+    if (mShader)
+    {
+        registry.destroyGL(GL_OBJECT_PROGRAM, &mShader->ID, 1);
+        glDeleteProgram(mShader->ID);
+    }
+}
+
+bool ObservationRenderer::initGPU(int maxBoards)
+{
+    // Lays the tiles out in a roughly square atlas
+    mAtlasColumns = (int) ceil(sqrt((double) maxBoards));
+    mAtlasRows = (maxBoards + mAtlasColumns - 1) / mAtlasColumns;
+    
+    int maxSize;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+    if (mAtlasColumns * mTileSize > maxSize || mAtlasRows * mTileSize > maxSize)
+    {
+        printf("ERROR::OBSERVATION::ATLAS_TOO_LARGE\n%d boards of %d pixels do not fit in %d pixels\n", maxBoards, mTileSize, maxSize);
+        return false;
+    }
+    mMaxBoards = maxBoards;
+    
+    // Color target for the whole atlas, observations are flat colored so no depth buffer is needed
+    glGenTextures(1, &mColorTexture);
+    glBindTexture(GL_TEXTURE_2D, mColorTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, mAtlasColumns * mTileSize, mAtlasRows * mTileSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    MemoryRegistry::get().createGL(GL_OBJECT_TEXTURE, &mColorTexture, 1, MEMORY_RENDER_TARGETS);
+    MemoryRegistry::get().resizeGL(GL_OBJECT_TEXTURE, mColorTexture, MemoryRegistry::textureBytes(mAtlasColumns * mTileSize, mAtlasRows * mTileSize, 4));
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    
+    glGenFramebuffers(1, &mFramebuffer);
+    MemoryRegistry::get().createGL(GL_OBJECT_FRAMEBUFFER, &mFramebuffer, 1, MEMORY_RENDER_TARGETS);
+    glBindFramebuffer(GL_FRAMEBUFFER, mFramebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, mColorTexture, 0);
+    
+    bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (!complete)
+    {
+        puts("ERROR::OBSERVATION::FRAMEBUFFER_INCOMPLETE");
+        return false;
+    }
+    
+    // A unit quad from the shared generator, with a per instance attribute added on top
+    generateQuadVAO(mQuadVAO, 0.5f, 0.5f);
+    glBindVertexArray(mQuadVAO);
+    
+    glGenBuffers(1, &mInstanceVBO);
+    MemoryRegistry::get().createGL(GL_OBJECT_BUFFER, &mInstanceVBO, 1, MEMORY_GEOMETRY);
+    glBindBuffer(GL_ARRAY_BUFFER, mInstanceVBO);
+    glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*) 0);
+    glEnableVertexAttribArray(4);
+    glVertexAttribDivisor(4, 1);
+    
+    glBindVertexArray(0);
+    
+    mShader.reset(new Shader("resources/obsShader.vert", "resources/obsShader.frag"));
+    
+    // The palette never changes, so it is uploaded once
+    mShader->use();
+    for (int i = 0; i < 4; i++)
+    {
+        std::string name = "palette[" + std::to_string(i) + "]";
+        uint32_t color = OBSERVATION_PALETTE[i];
+        mShader->setUniform(name.c_str(), (color & 0xFF) / 255.0f, ((color >> 8) & 0xFF) / 255.0f, ((color >> 16) & 0xFF) / 255.0f);
+    }
+    mShader->setUniform("atlasTiles", (float) mAtlasColumns, (float) mAtlasRows);
+    
+    return true;
+}
+
+void ObservationRenderer::renderGPU(const std::vector<const Board*> &boards, std::vector<uint8_t> &pixels)
+{
+    size_t tileBytes = (size_t) mTileSize * mTileSize * 4;
+    pixels.resize(boards.size() * tileBytes);
+    if (boards.empty() || mFramebuffer == 0)
+        return;
+    
+    int width = boards[0]->getWidth(), height = boards[0]->getHeight();
+    int atlasWidth = mAtlasColumns * mTileSize;
+    
+    // Saves the state that is changed so that the caller's frame is left as it was
+    int viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    bool depthTest = glIsEnabled(GL_DEPTH_TEST);
+    glDisable(GL_DEPTH_TEST);
+    
+    glBindFramebuffer(GL_FRAMEBUFFER, mFramebuffer);
+    glViewport(0, 0, atlasWidth, mAtlasRows * mTileSize);
+    
+    mShader->use();
+    mShader->setUniform("cellSize", 1.0f / width, 1.0f / height);
+    glBindVertexArray(mQuadVAO);
+    
+    // Empty cells are the clear color, so only food and snakes become instances
+    uint32_t empty = OBSERVATION_PALETTE[0];
+    glClearColor((empty & 0xFF) / 255.0f, ((empty >> 8) & 0xFF) / 255.0f, ((empty >> 16) & 0xFF) / 255.0f, 1.0f);
+    
+    for (size_t first = 0; first < boards.size(); first += mMaxBoards)
+    {
+        size_t batch = std::min(boards.size() - first, (size_t) mMaxBoards);
+        
+        // One instance per non empty cell: tile, cell center in tile space, palette entry
+        mInstances.clear();
+        for (size_t tile = 0; tile < batch; tile++)
+        {
+            const Board &board = *boards[first + tile];
+            for (int cell = 0; cell < width * height; cell++)
+            {
+                uint8_t contents = board.getCell(cell);
+                if (contents == CELL_EMPTY)
+                    continue;
+                
+                mInstances.push_back((float) tile);
+                mInstances.push_back((cell % width + 0.5f) / width);
+                mInstances.push_back((cell / width + 0.5f) / height);
+                mInstances.push_back((float) paletteIndex(contents));
+            }
+        }
+        
+        // Orphans the old storage so the upload does not wait on the previous batch
+        glBindBuffer(GL_ARRAY_BUFFER, mInstanceVBO);
+        glBufferData(GL_ARRAY_BUFFER, mInstances.size() * sizeof(float), nullptr, GL_STREAM_DRAW);
+        MemoryRegistry::get().resizeGL(GL_OBJECT_BUFFER, mInstanceVBO, mInstances.size() * sizeof(float));
+        glBufferSubData(GL_ARRAY_BUFFER, 0, mInstances.size() * sizeof(float), mInstances.data());
+        
+        glClear(GL_COLOR_BUFFER_BIT);
+        glDrawElementsInstanced(GL_TRIANGLES, QUAD_INDEX_COUNT, GL_UNSIGNED_INT, (void*) 0, (GLsizei) (mInstances.size() / 4));
+        
+        // Reads back only the atlas rows this batch used
+        int usedRows = (int) ((batch + mAtlasColumns - 1) / mAtlasColumns) * mTileSize;
+        mAtlasPixels.resize((size_t) atlasWidth * usedRows * 4);
+        glPixelStorei(GL_PACK_ALIGNMENT, 4);
+        glReadPixels(0, 0, atlasWidth, usedRows, GL_RGBA, GL_UNSIGNED_BYTE, mAtlasPixels.data());
+        
+        // Copies every tile out of the atlas, flipping it so that row 0 is the top
+        for (size_t tile = 0; tile < batch; tile++)
+        {
+            int tileX = (int) (tile % mAtlasColumns) * mTileSize, tileY = (int) (tile / mAtlasColumns) * mTileSize;
+            uint8_t* destination = &pixels[(first + tile) * tileBytes];
+            
+            for (int row = 0; row < mTileSize; row++)
+            {
+                const uint8_t* source = &mAtlasPixels[((size_t) (tileY + mTileSize - 1 - row) * atlasWidth + tileX) * 4];
+                memcpy(destination + (size_t) row * mTileSize * 4, source, mTileSize * 4);
+            }
+        }
+    }
+    
+    glBindVertexArray(0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    if (depthTest)
+        glEnable(GL_DEPTH_TEST);
+}
+
+void ObservationRenderer::renderCPU(const std::vector<const Board*> &boards, std::vector<uint8_t> &pixels)
+{
+    size_t tileBytes = (size_t) mTileSize * mTileSize * 4;
+    pixels.resize(boards.size() * tileBytes);
+    if (boards.empty())
+        return;
+    
+    int width = boards[0]->getWidth(), height = boards[0]->getHeight();
+    updateEdges(width, height);
+    
+    for (size_t tile = 0; tile < boards.size(); tile++)
+    {
+        const Board &board = *boards[tile];
+        uint32_t* image = (uint32_t*) &pixels[tile * tileBytes];
+        
+        for (int y = 0; y < height; y++)
+        {
+            // Board rows run south to north, image rows top to bottom
+            int top = mTileSize - mRowEdges[y + 1], bottom = mTileSize - mRowEdges[y];
+            if (top >= bottom)
+                continue;
+            
+            // Rasterizes the first image row of this board row span by span
+            uint32_t* row = image + (size_t) top * mTileSize;
+            for (int x = 0; x < width; x++)
+                fillSpan(row + mColumnEdges[x], mColumnEdges[x + 1] - mColumnEdges[x], OBSERVATION_PALETTE[paletteIndex(board.getCell(y * width + x))]);
+            
+            // Every other image row covered by the board row is identical
+            for (int copy = top + 1; copy < bottom; copy++)
+                memcpy(image + (size_t) copy * mTileSize, row, mTileSize * 4);
+        }
+    }
+}
+
+int ObservationRenderer::getTileSize() const
+{
+    return mTileSize;
+}
+
+void ObservationRenderer::updateEdges(int width, int height)
+{
+    if (width == mEdgeWidth && height == mEdgeHeight)
+        return;
+    
+    mEdgeWidth = width;
+    mEdgeHeight = height;
+    
+    // Uses the same rule as GL rasterization: a pixel belongs to a cell if its center is inside it
+    mColumnEdges.resize(width + 1);
+    for (int x = 0; x <= width; x++)
+        mColumnEdges[x] = std::min(mTileSize, std::max(0, (int) ceil((double) x * mTileSize / width - 0.5)));
+    
+    mRowEdges.resize(height + 1);
+    for (int y = 0; y <= height; y++)
+        mRowEdges[y] = std::min(mTileSize, std::max(0, (int) ceil((double) y * mTileSize / height - 0.5)));
+}
@@ -0,0 +1,72 @@
+//
+//  observation.hpp
+//  SnakeGL
+//
+//  Created by Keegan Bilodeau on 10/19/26.
+//  Copyright © 2026 Keegan Bilodeau. All rights reserved.
+//
+
+#ifndef observation_hpp
+#define observation_hpp
+
+#include <stdio.h>
+#include <stdint.h>
+#include <memory>
+#include <vector>
+
+#include "board.hpp"
+#include "shader.hpp"
+
+// Palette entries used for observations, in RGBA8 (red in the lowest byte)
+const uint32_t OBSERVATION_PALETTE[4] = {
+    0xFF232323, // Empty
+    0xFF3333E6, // Food
+    0xFF4CCC33, // Body
+    0xFF339919  // Head
+};
+
+// Renders small top down images of many boards at once, for example as training observations
+// Every board becomes one tileSize x tileSize RGBA8 image, and a batch of boards is written to one
+// contiguous buffer laid out as [board][row][column][channel] with row 0 at the top (north)
+// All boards in a batch must have the same dimensions
+class ObservationRenderer
+{
+public:
+    ObservationRenderer(int tileSize = 84);
+    ~ObservationRenderer();
+    
+    // Creates the atlas framebuffer, shader and instanced quad used by renderGPU
+    // Needs a current GL context, returns false if the atlas would be too large
+    bool initGPU(int maxBoards = 1024);
+    
+    // Draws every board into its own tile of one atlas framebuffer with a single instanced draw per
+    // batch of maxBoards, then reads the atlas back into pixels
+    // Changes the bound program, vertex array and framebuffer, so a GLStateCache must be invalidated afterwards
+    void renderGPU(const std::vector<const Board*> &boards, std::vector<uint8_t> &pixels);
+    
+    // Rasterizes the same images on the CPU with SIMD span fills, no GL needed
+    void renderCPU(const std::vector<const Board*> &boards, std::vector<uint8_t> &pixels);
+    
+    // Size in pixels of one board's image
+    int getTileSize() const;
+
+private:
+    // Rebuilds the pixel edges of every cell for a board size
+    void updateEdges(int width, int height);
+    
+    int mTileSize, mMaxBoards, mAtlasColumns, mAtlasRows;
+    
+    // GL objects for the atlas and the instanced quad
+    unsigned int mFramebuffer, mColorTexture, mQuadVAO, mInstanceVBO;
+    std::unique_ptr<Shader> mShader;
+    
+    // Per frame instance data and the pixels read back from the atlas
+    std::vector<float> mInstances;
+    std::vector<uint8_t> mAtlasPixels;
+    
+    // First pixel column and row of every cell (plus one past the end), shared by both paths
+    std::vector<int> mColumnEdges, mRowEdges;
+    int mEdgeWidth, mEdgeHeight;
+};
+
+#endif /* observation_hpp */
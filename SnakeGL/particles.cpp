@@ -0,0 +1,432 @@
+//
+//  particles.cpp
+//  SnakeGL
+//
+//  Created by Keegan Bilodeau on 10/19/26.
+//  Copyright © 2026 Keegan Bilodeau. All rights reserved.
+//
+
+#include "particles.hpp"
+
+#include <math.h>
+#include <algorithm>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#include "memory.hpp"
+#include "renderable.hpp"
+
+// Packs a color into RGBA8 with red in the lowest byte
+static uint32_t packColor(const glm::vec3 &color)
+{
+    uint32_t packed = 0xFF000000;
+    for (int i = 0; i < 3; i++)
+        packed |= (uint32_t) (fminf(fmaxf(color[i], 0.0f), 1.0f) * 255.0f + 0.5f) << (i * 8);
+    
+    return packed;
+}
+
+ParticleSystem::ParticleSystem(size_t maxParticles) : gravity(0.0f, -0.8f, 0.0f), particleSize(0.012f), mCount(0), mMode(PARTICLES_CPU), mSeed(2463534242u), mRingCursor(0), mRingUsed(0), mClock(0.0f), mRingExpiry(0.0f), mPendingTime(0.0f), mCpuVAO(0), mInstanceVBO(0), mGpuVAOs{0, 0}, mUpdateVAOs{0, 0}, mStateVBOs{0, 0}, mCurrentState(0), mGpuSupported(false)
+{
+    // Padding to whole groups of four lets the integration loop run without a scalar tail
+    mCapacity = (maxParticles + 3) & ~(size_t) 3;
+    
+    mPosX.resize(mCapacity);
+    mPosY.resize(mCapacity);
+    mPosZ.resize(mCapacity);
+    mVelX.resize(mCapacity);
+    mVelY.resize(mCapacity);
+    mVelZ.resize(mCapacity);
+    mLife.resize(mCapacity);
+    mColor.resize(mCapacity);
+    MemoryRegistry::get().setCPU(this, MEMORY_PARTICLES, mCapacity * 8 * sizeof(float));
+}
+
+ParticleSystem::~ParticleSystem()
+{
+    MemoryRegistry &registry = MemoryRegistry::get();
+    registry.releaseCPU(this);
+    
+    // initGPU creates each program before checking that it linked, so they are freed on their own
+    if (mShader)
+    {
+        registry.destroyGL(GL_OBJECT_PROGRAM, &mShader->ID, 1);
+        glDeleteProgram(mShader->ID);
+    }
+    if (mUpdateShader)
+    {
+        registry.destroyGL(GL_OBJECT_PROGRAM, &mUpdateShader->ID, 1);
+        glDeleteProgram(mUpdateShader->ID);
+    }
+    
+    if (mCpuVAO != 0)
+    {
+        registry.destroyGL(GL_OBJECT_VERTEX_ARRAY, &mCpuVAO, 1);
+        registry.destroyGL(GL_OBJECT_BUFFER, &mInstanceVBO, 1);
+        glDeleteVertexArrays(1, &mCpuVAO);
+        glDeleteBuffers(1, &mInstanceVBO);
+    }
+    
+    if (mStateVBOs[0] != 0)
+    {
+        registry.destroyGL(GL_OBJECT_VERTEX_ARRAY, mGpuVAOs, 2);
+        registry.destroyGL(GL_OBJECT_VERTEX_ARRAY, mUpdateVAOs, 2);
+        registry.destroyGL(GL_OBJECT_BUFFER, mStateVBOs, 2);
+        glDeleteVertexArrays(2, mGpuVAOs);
+        glDeleteVertexArrays(2, mUpdateVAOs);
+        glDeleteBuffers(2, mStateVBOs);
+    }
+}
+
+bool ParticleSystem::initGPU()
+{
+    mShader.reset(new Shader("resources/particleShader.vert", "resources/particleShader.frag"));
+    if (!mShader->linked)
+        return false;
+    
+    // Every instance array gets its own section of one buffer, sized for the whole pool
+    generateQuadVAO(mCpuVAO, 0.5f, 0.5f);
+    glGenBuffers(1, &mInstanceVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, mInstanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, mCapacity * 5 * sizeof(float), nullptr, GL_STREAM_DRAW);
+    MemoryRegistry::get().createGL(GL_OBJECT_BUFFER, &mInstanceVBO, 1, MEMORY_PARTICLES);
+    MemoryRegistry::get().resizeGL(GL_OBJECT_BUFFER, mInstanceVBO, mCapacity * 5 * sizeof(float));
+    bindInstanceAttributes(mCpuVAO, mInstanceVBO, false);
+    
+    // GPU simulation needs transform feedback, which is core since GL 3.0
+    mUpdateShader.reset(new Shader("resources/particleUpdate.vert", {"outPosition", "outVelocity", "outLife", "outColor"}));
+    mGpuSupported = GLAD_GL_VERSION_3_0 && mUpdateShader->linked;
+    if (!mGpuSupported)
+    {
+        puts("Particle GPU simulation is not supported, using the CPU");
+        return true;
+    }
+    
+    glGenBuffers(2, mStateVBOs);
+    glGenVertexArrays(2, mUpdateVAOs);
+    MemoryRegistry::get().createGL(GL_OBJECT_BUFFER, mStateVBOs, 2, MEMORY_PARTICLES);
+    MemoryRegistry::get().createGL(GL_OBJECT_VERTEX_ARRAY, mUpdateVAOs, 2, MEMORY_PARTICLES);
+    for (int i = 0; i < 2; i++)
+    {
+        // Zeroed state means every slot starts out dead
+        std::vector<GPUParticle> empty(mCapacity, GPUParticle());
+        glBindBuffer(GL_ARRAY_BUFFER, mStateVBOs[i]);
+        glBufferData(GL_ARRAY_BUFFER, mCapacity * sizeof(GPUParticle), empty.data(), GL_DYNAMIC_COPY);
+        MemoryRegistry::get().resizeGL(GL_OBJECT_BUFFER, mStateVBOs[i], mCapacity * sizeof(GPUParticle));
+        
+        // Draws from one state buffer for rendering
+        generateQuadVAO(mGpuVAOs[i], 0.5f, 0.5f);
+        bindInstanceAttributes(mGpuVAOs[i], mStateVBOs[i], true);
+        
+        // And reads it as plain vertices for the update pass
+        glBindVertexArray(mUpdateVAOs[i]);
+        glBindBuffer(GL_ARRAY_BUFFER, mStateVBOs[i]);
+        
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(GPUParticle), (void*) offsetof(GPUParticle, position));
+        glEnableVertexAttribArray(0);
+        
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(GPUParticle), (void*) offsetof(GPUParticle, velocity));
+        glEnableVertexAttribArray(1);
+        
+        glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, sizeof(GPUParticle), (void*) offsetof(GPUParticle, life));
+        glEnableVertexAttribArray(2);
+        
+        glVertexAttribIPointer(3, 1, GL_UNSIGNED_INT, sizeof(GPUParticle), (void*) offsetof(GPUParticle, color));
+        glEnableVertexAttribArray(3);
+    }
+    
+    glBindVertexArray(0);
+    
+    return true;
+}
+
+bool ParticleSystem::setMode(ParticleMode mode)
+{
+    if (mode == PARTICLES_GPU && !mGpuSupported)
+        return false;
+    
+    if (mode != mMode)
+    {
+        mCount = 0;
+        mRingCursor = 0;
+        mRingUsed = 0;
+        mEmitted.clear();
+    }
+    mMode = mode;
+    
+    return true;
+}
+
+ParticleMode ParticleSystem::getMode() const
+{
+    return mMode;
+}
+
+void ParticleSystem::emit(const glm::vec3 &position, int count, const glm::vec3 &color, float speed, float lifetime)
+{
+    uint32_t packed = packColor(color);
+    
+    for (int i = 0; i < count; i++)
+    {
+        // Random direction with a random share of the speed, so a burst fills a ball instead of a shell
+        glm::vec3 direction(random(), random(), random());
+        if (glm::length(direction) > 0.0f)
+            direction = glm::normalize(direction);
+        glm::vec3 velocity = direction * speed * (0.55f + 0.45f * random());
+        float life = lifetime * (0.875f + 0.125f * random());
+        
+        if (mMode == PARTICLES_GPU)
+        {
+            // GPU particles are written into the ring on the next render
+            mEmitted.push_back(GPUParticle{{position.x, position.y, position.z}, {velocity.x, velocity.y, velocity.z}, life, packed});
+            mRingExpiry = std::max(mRingExpiry, mClock + life);
+            continue;
+        }
+        
+        // A full pool drops the rest of the burst
+        if (mCount == mCapacity)
+            return;
+        
+        mPosX[mCount] = position.x;
+        mPosY[mCount] = position.y;
+        mPosZ[mCount] = position.z;
+        mVelX[mCount] = velocity.x;
+        mVelY[mCount] = velocity.y;
+        mVelZ[mCount] = velocity.z;
+        mLife[mCount] = life;
+        mColor[mCount] = packed;
+        mCount++;
+    }
+}
+
+void ParticleSystem::update(float deltaTime)
+{
+    mClock += deltaTime;
+    
+    // The GPU pass runs in render, where the GL state can go through the cache
+    if (mMode == PARTICLES_GPU)
+    {
+        mPendingTime += deltaTime;
+        return;
+    }
+    
+    integrate(deltaTime);
+    compact();
+}
+
+void ParticleSystem::render(GLStateCache &cache, const glm::mat4 &view, const glm::mat4 &projection)
+{
+    // Nothing is drawn if the particle shader failed to link
+    if (mShader == nullptr || mCpuVAO == 0)
+        return;
+    
+    if (mMode == PARTICLES_GPU)
+        updateGPU(cache);
+    
+    size_t instances = mMode == PARTICLES_GPU ? mRingUsed : mCount;
+    if (instances == 0)
+        return;
+    
+    // CPU particles upload every array into its own section, no repacking needed
+    if (mMode == PARTICLES_CPU)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, mInstanceVBO);
+        glBufferData(GL_ARRAY_BUFFER, mCapacity * 5 * sizeof(float), nullptr, GL_STREAM_DRAW);
+        
+        const void* sections[5] = {mPosX.data(), mPosY.data(), mPosZ.data(), mLife.data(), mColor.data()};
+        for (int i = 0; i < 5; i++)
+            glBufferSubData(GL_ARRAY_BUFFER, i * mCapacity * sizeof(float), mCount * sizeof(float), sections[i]);
+    }
+    
+    // Particles glow additively and do not hide each other
+    bool blend = glIsEnabled(GL_BLEND);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+    glDepthMask(GL_FALSE);
+    
+    cache.useProgram(mShader->ID);
+    cache.setUniform("view", view);
+    cache.setUniform("projection", projection);
+    cache.setUniform("particleSize", particleSize);
+    cache.bindVertexArray(mMode == PARTICLES_GPU ? mGpuVAOs[mCurrentState] : mCpuVAO);
+    
+    glDrawElementsInstanced(GL_TRIANGLES, QUAD_INDEX_COUNT, GL_UNSIGNED_INT, (void*) 0, (GLsizei) instances);
+    
+    glDepthMask(GL_TRUE);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    if (!blend)
+        glDisable(GL_BLEND);
+}
+
+size_t ParticleSystem::getCount() const
+{
+    return mMode == PARTICLES_GPU ? mRingUsed : mCount;
+}
+
+float ParticleSystem::random()
+{
+    mSeed ^= mSeed << 13;
+    mSeed ^= mSeed >> 17;
+    mSeed ^= mSeed << 5;
+    
+    return (mSeed & 0xFFFFFF) / (float) 0x7FFFFF - 1.0f;
+}
+
+void ParticleSystem::integrate(float deltaTime)
+{
+    size_t i = 0;
+
+#if defined(__SSE2__)
+    __m128 dt = _mm_set1_ps(deltaTime);
+    __m128 gx = _mm_set1_ps(gravity.x * deltaTime), gy = _mm_set1_ps(gravity.y * deltaTime), gz = _mm_set1_ps(gravity.z * deltaTime);
+    
+    // Velocity picks up gravity first, then moves the position (semi implicit Euler)
+    for (; i < mCount; i += 4)
+    {
+        __m128 vx = _mm_add_ps(_mm_load_ps(&mVelX[i]), gx);
+        __m128 vy = _mm_add_ps(_mm_load_ps(&mVelY[i]), gy);
+        __m128 vz = _mm_add_ps(_mm_load_ps(&mVelZ[i]), gz);
+        _mm_store_ps(&mVelX[i], vx);
+        _mm_store_ps(&mVelY[i], vy);
+        _mm_store_ps(&mVelZ[i], vz);
+        
+        _mm_store_ps(&mPosX[i], _mm_add_ps(_mm_load_ps(&mPosX[i]), _mm_mul_ps(vx, dt)));
+        _mm_store_ps(&mPosY[i], _mm_add_ps(_mm_load_ps(&mPosY[i]), _mm_mul_ps(vy, dt)));
+        _mm_store_ps(&mPosZ[i], _mm_add_ps(_mm_load_ps(&mPosZ[i]), _mm_mul_ps(vz, dt)));
+        _mm_store_ps(&mLife[i], _mm_sub_ps(_mm_load_ps(&mLife[i]), dt));
+    }
+#elif defined(__ARM_NEON)
+    float32x4_t dt = vdupq_n_f32(deltaTime);
+    float32x4_t gx = vdupq_n_f32(gravity.x * deltaTime), gy = vdupq_n_f32(gravity.y * deltaTime), gz = vdupq_n_f32(gravity.z * deltaTime);
+    
+    // Velocity picks up gravity first, then moves the position (semi implicit Euler)
+    for (; i < mCount; i += 4)
+    {
+        float32x4_t vx = vaddq_f32(vld1q_f32(&mVelX[i]), gx);
+        float32x4_t vy = vaddq_f32(vld1q_f32(&mVelY[i]), gy);
+        float32x4_t vz = vaddq_f32(vld1q_f32(&mVelZ[i]), gz);
+        vst1q_f32(&mVelX[i], vx);
+        vst1q_f32(&mVelY[i], vy);
+        vst1q_f32(&mVelZ[i], vz);
+        
+        vst1q_f32(&mPosX[i], vmlaq_f32(vld1q_f32(&mPosX[i]), vx, dt));
+        vst1q_f32(&mPosY[i], vmlaq_f32(vld1q_f32(&mPosY[i]), vy, dt));
+        vst1q_f32(&mPosZ[i], vmlaq_f32(vld1q_f32(&mPosZ[i]), vz, dt));
+        vst1q_f32(&mLife[i], vsubq_f32(vld1q_f32(&mLife[i]), dt));
+    }
+#endif
+    
+    for (; i < mCount; i++)
+    {
+        mVelX[i] += gravity.x * deltaTime;
+        mVelY[i] += gravity.y * deltaTime;
+        mVelZ[i] += gravity.z * deltaTime;
+        mPosX[i] += mVelX[i] * deltaTime;
+        mPosY[i] += mVelY[i] * deltaTime;
+        mPosZ[i] += mVelZ[i] * deltaTime;
+        mLife[i] -= deltaTime;
+    }
+}
+
+void ParticleSystem::compact()
+{
+    size_t i = 0;
+    while (i < mCount)
+    {
+        if (mLife[i] > 0.0f)
+        {
+            i++;
+            continue;
+        }
+        
+        // The last particle takes the dead one's place and is checked next
+        size_t last = --mCount;
+        mPosX[i] = mPosX[last];
+        mPosY[i] = mPosY[last];
+        mPosZ[i] = mPosZ[last];
+        mVelX[i] = mVelX[last];
+        mVelY[i] = mVelY[last];
+        mVelZ[i] = mVelZ[last];
+        mLife[i] = mLife[last];
+        mColor[i] = mColor[last];
+    }
+}
+
+void ParticleSystem::updateGPU(GLStateCache &cache)
+{
+    // Once everything that was emitted has died the ring starts over from the beginning
+    if (mClock > mRingExpiry && mEmitted.empty())
+    {
+        mRingCursor = 0;
+        mRingUsed = 0;
+    }
+    
+    // New particles go into the current state buffer at the ring cursor, wrapping around at the end
+    if (!mEmitted.empty())
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, mStateVBOs[mCurrentState]);
+        
+        size_t written = 0, total = std::min(mEmitted.size(), mCapacity);
+        while (written < total)
+        {
+            size_t chunk = std::min(total - written, mCapacity - mRingCursor);
+            glBufferSubData(GL_ARRAY_BUFFER, mRingCursor * sizeof(GPUParticle), chunk * sizeof(GPUParticle), &mEmitted[written]);
+            
+            written += chunk;
+            mRingCursor = (mRingCursor + chunk) % mCapacity;
+            mRingUsed = std::max(mRingUsed, mRingCursor == 0 ? mCapacity : mRingCursor);
+        }
+        
+        mEmitted.clear();
+        
+        // The staging list keeps the capacity of the largest burst
+        MemoryRegistry::get().setCPU(this, MEMORY_PARTICLES, mCapacity * 8 * sizeof(float) + mEmitted.capacity() * sizeof(GPUParticle));
+    }
+    
+    if (mRingUsed == 0 || mPendingTime <= 0.0f)
+        return;
+    
+    // Integrates every used slot into the other state buffer without rasterizing anything
+    cache.useProgram(mUpdateShader->ID);
+    cache.setUniform("deltaTime", mPendingTime);
+    cache.setUniform("gravity", gravity);
+    cache.bindVertexArray(mUpdateVAOs[mCurrentState]);
+    
+    glEnable(GL_RASTERIZER_DISCARD);
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, mStateVBOs[1 - mCurrentState]);
+    glBeginTransformFeedback(GL_POINTS);
+    glDrawArrays(GL_POINTS, 0, (GLsizei) mRingUsed);
+    glEndTransformFeedback();
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+    glDisable(GL_RASTERIZER_DISCARD);
+    
+    // Slots past the used range were not written, which is fine because they are never read
+    mCurrentState = 1 - mCurrentState;
+    mPendingTime = 0.0f;
+}
+
+void ParticleSystem::bindInstanceAttributes(unsigned int VAO, unsigned int buffer, bool interleaved)
+{
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    
+    // Position components, remaining life and color, each advancing once per instance
+    for (int i = 0; i < 4; i++)
+    {
+        size_t offset = interleaved ? (i < 3 ? offsetof(GPUParticle, position) + i * sizeof(float) : offsetof(GPUParticle, life)) : i * mCapacity * sizeof(float);
+        glVertexAttribPointer(4 + i, 1, GL_FLOAT, GL_FALSE, interleaved ? sizeof(GPUParticle) : sizeof(float), (void*) offset);
+        glEnableVertexAttribArray(4 + i);
+        glVertexAttribDivisor(4 + i, 1);
+    }
+    
+    size_t colorOffset = interleaved ? offsetof(GPUParticle, color) : 4 * mCapacity * sizeof(float);
+    glVertexAttribPointer(8, 4, GL_UNSIGNED_BYTE, GL_TRUE, interleaved ? sizeof(GPUParticle) : sizeof(uint32_t), (void*) colorOffset);
+    glEnableVertexAttribArray(8);
+    glVertexAttribDivisor(8, 1);
+    
+    glBindVertexArray(0);
+}
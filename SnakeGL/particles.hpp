@@ -0,0 +1,117 @@
+//
+//  particles.hpp
+//  SnakeGL
+//
+//  Created by Keegan Bilodeau on 10/19/26.
+//  Copyright © 2026 Keegan Bilodeau. All rights reserved.
+//
+
+#ifndef particles_hpp
+#define particles_hpp
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <memory>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "renderqueue.hpp"
+#include "shader.hpp"
+
+// Where particles are simulated
+enum ParticleMode
+{
+    PARTICLES_CPU,
+    PARTICLES_GPU
+};
+
+// State of one particle in GPU mode, interleaved the way the transform feedback shader writes it
+struct GPUParticle
+{
+    float position[3];
+    float velocity[3];
+    float life;
+    uint32_t color;
+};
+
+// Short lived, unlit particles drawn as camera facing instanced quads
+// On the CPU particles live in a structure of arrays pool that is integrated four at a time and
+// kept dense by swap removing dead particles, so every array uploads straight into its own
+// instance attribute. In GPU mode a transform feedback pass integrates a ring of particle slots
+// instead and nothing but newly emitted particles crosses the bus
+class ParticleSystem
+{
+public:
+    ParticleSystem(size_t maxParticles = 262144);
+    ~ParticleSystem();
+    
+    // Creates the quad, instance buffers and shaders, GPU simulation is set up when the driver supports it
+    // Needs a current GL context, changes the bound vertex array so a GLStateCache must be invalidated afterwards
+    bool initGPU();
+    
+    // Switches between CPU and GPU simulation, returns false if GPU simulation is not available
+    // Live particles are dropped when the mode changes
+    bool setMode(ParticleMode mode);
+    ParticleMode getMode() const;
+    
+    // Emits a burst of particles flying out of position in random directions, each living 75% to 100% of lifetime
+    void emit(const glm::vec3 &position, int count, const glm::vec3 &color, float speed, float lifetime);
+    
+    // Moves every particle and retires the ones whose life ran out
+    // In GPU mode the time is only collected, the simulation runs at the start of render
+    void update(float deltaTime);
+    
+    // Draws every particle with a single instanced draw
+    void render(GLStateCache &cache, const glm::mat4 &view, const glm::mat4 &projection);
+    
+    // Live particles (in GPU mode the number of slots in use, which may include some that already died)
+    size_t getCount() const;
+    
+    // Constant acceleration applied to every particle and the size of a particle in world units
+    glm::vec3 gravity;
+    float particleSize;
+
+private:
+    // Returns a random float in [-1, 1]
+    float random();
+    
+    // Integrates the CPU pool four particles at a time
+    void integrate(float deltaTime);
+    
+    // Removes dead particles from the CPU pool by moving the last live particle into their place
+    void compact();
+    
+    // Writes newly emitted particles into the GPU ring and runs the transform feedback pass over it
+    void updateGPU(GLStateCache &cache);
+    
+    // Adds the instance attributes to a quad vertex array, either from the separate CPU arrays or the interleaved GPU state
+    void bindInstanceAttributes(unsigned int VAO, unsigned int buffer, bool interleaved);
+    
+    size_t mCapacity, mCount;
+    ParticleMode mMode;
+    uint32_t mSeed;
+    
+    // Structure of arrays pool, each array is padded to a multiple of four floats
+    std::vector<float> mPosX, mPosY, mPosZ, mVelX, mVelY, mVelZ, mLife;
+    std::vector<uint32_t> mColor;
+    
+    // GPU ring: the next slot to emit into, the number of slots that have been used and the particles
+    // waiting to be written into it
+    size_t mRingCursor, mRingUsed;
+    std::vector<GPUParticle> mEmitted;
+    
+    // Simulated time, the time at which every particle in the ring will have died, and time not yet simulated on the GPU
+    float mClock, mRingExpiry, mPendingTime;
+    
+    // Quad and instance buffer for CPU mode, and the two state buffers GPU mode ping pongs between
+    unsigned int mCpuVAO, mInstanceVBO;
+    unsigned int mGpuVAOs[2], mUpdateVAOs[2], mStateVBOs[2];
+    int mCurrentState;
+    bool mGpuSupported;
+    
+    std::unique_ptr<Shader> mShader, mUpdateShader;
+};
+
+#endif /* particles_hpp */
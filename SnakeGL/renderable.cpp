@@ -7,6 +7,7 @@
 //
 
 #include "renderable.hpp"
+#include "memory.hpp"
 
 #include <stb_image.h>
 #include <string>
@@ -14,6 +15,7 @@
 void loadTexture(std::string textureName, unsigned int &texture, bool alpha)
 {
     glGenTextures(1, &texture);
+    MemoryRegistry::get().createGL(GL_OBJECT_TEXTURE, &texture, 1, MEMORY_TEXTURES);
     glBindTexture(GL_TEXTURE_2D, texture);
     
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -32,6 +34,7 @@ void loadTexture(std::string textureName, unsigned int &texture, bool alpha)
             glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
         
         glGenerateMipmap(GL_TEXTURE_2D);
+        MemoryRegistry::get().resizeGL(GL_OBJECT_TEXTURE, texture, MemoryRegistry::textureBytes(width, height, alpha ? 4 : 3, true));
     }
     else
         puts("Failed to load texture!");
@@ -47,6 +50,7 @@ void generateTriVAO(unsigned int &VAO, float w, float h)
 void generateTriVAO(unsigned int &VAO, float w, float h, float r, float g, float b, bool texture)
 {
     glGenVertexArrays(1, &VAO);
+    MemoryRegistry::get().createGL(GL_OBJECT_VERTEX_ARRAY, &VAO, 1, MEMORY_GEOMETRY);
     glBindVertexArray(VAO);
     
     Vertex vertices[] = {
@@ -79,6 +83,9 @@ void generateTriVAO(unsigned int &VAO, float w, float h, float r, float g, float
     
     glBindVertexArray(0);
     
+    // The buffer lives on as long as the VAO references it, so its storage is counted against the VAO
+    MemoryRegistry::get().resizeGL(GL_OBJECT_VERTEX_ARRAY, VAO, sizeof(vertices));
+    
     glDeleteBuffers(1, &VBO);
 }
 
@@ -90,6 +97,7 @@ void generateQuadVAO(unsigned int &VAO, float w, float h, bool texture)
 void generateQuadVAO(unsigned int &VAO, float w, float h, float r, float g, float b, bool texture)
 {
     glGenVertexArrays(1, &VAO);
+    MemoryRegistry::get().createGL(GL_OBJECT_VERTEX_ARRAY, &VAO, 1, MEMORY_GEOMETRY);
     glBindVertexArray(VAO);
     
     Quad vertices[] = {
@@ -134,6 +142,9 @@ void generateQuadVAO(unsigned int &VAO, float w, float h, float r, float g, floa
     
     glBindVertexArray(0);
     
+    // The buffers live on as long as the VAO references them, so their storage is counted against the VAO
+    MemoryRegistry::get().resizeGL(GL_OBJECT_VERTEX_ARRAY, VAO, sizeof(vertices) + sizeof(indices));
+    
     glDeleteBuffers(1, &VBO);
     glDeleteBuffers(1, &EBO);
 }
@@ -146,6 +157,7 @@ void generateCubeVAO(unsigned int &VAO, float w, float h, bool texture)
 void generateCubeVAO(unsigned int &VAO, float w, float h, float r, float g, float b, bool texture)
 {
     glGenVertexArrays(1, &VAO);
+    MemoryRegistry::get().createGL(GL_OBJECT_VERTEX_ARRAY, &VAO, 1, MEMORY_GEOMETRY);
     glBindVertexArray(VAO);
     
     Cube vertices[] = {
@@ -245,6 +257,9 @@ void generateCubeVAO(unsigned int &VAO, float w, float h, float r, float g, floa
     
     glBindVertexArray(0);
     
+    // The buffers live on as long as the VAO references them, so their storage is counted against the VAO
+    MemoryRegistry::get().resizeGL(GL_OBJECT_VERTEX_ARRAY, VAO, sizeof(vertices) + sizeof(indices));
+    
     glDeleteBuffers(1, &VBO);
     glDeleteBuffers(1, &EBO);
 }
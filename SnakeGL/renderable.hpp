@@ -32,8 +32,12 @@ struct Cube
     Quad quads[6];
 };
 
+// Number of vertices or indices drawn for each generated shape
+const unsigned int TRI_VERTEX_COUNT = 3, QUAD_INDEX_COUNT = 6, CUBE_INDEX_COUNT = 36;
+
 void loadTexture(std::string textureName, unsigned int &texture, bool alpha = false);
 
+// texture enables the texture coordinate attribute, such VAOs are drawn with a FEATURE_TEXTURED shader variant
 void generateTriVAO(unsigned int &VAO, float w, float h);
 void generateTriVAO(unsigned int &VAO, float w, float h, float r, float g, float b, bool texture = false);
 
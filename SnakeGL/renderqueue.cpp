@@ -0,0 +1,313 @@
+//
+//  renderqueue.cpp
+//  SnakeGL
+//
+//  Created by Keegan Bilodeau on 10/19/26.
+//  Copyright © 2026 Keegan Bilodeau. All rights reserved.
+//
+
+#include "renderqueue.hpp"
+
+#include <string.h>
+
+#include <glm/gtc/type_ptr.hpp>
+
+// Bits of the sort key given to each field
+const int KEY_PASS_BITS = 4, KEY_ID_BITS = 12, KEY_DEPTH_BITS = 24;
+const uint64_t KEY_ID_MASK = (1ull << KEY_ID_BITS) - 1, KEY_DEPTH_MAX = (1ull << KEY_DEPTH_BITS) - 1;
+
+GLStateCache::GLStateCache()
+{
+    invalidate();
+    resetStats();
+}
+
+void GLStateCache::useProgram(unsigned int program)
+{
+    // Skip the call if the program is already in use
+    if (program == mProgram)
+    {
+        skippedCalls++;
+        return;
+    }
+    
+    glUseProgram(program);
+    mProgram = program;
+    programChanges++;
+}
+
+void GLStateCache::bindVertexArray(unsigned int VAO)
+{
+    // Skip the call if the vertex array is already bound
+    if (VAO == mVAO)
+    {
+        skippedCalls++;
+        return;
+    }
+    
+    glBindVertexArray(VAO);
+    mVAO = VAO;
+    vaoChanges++;
+}
+
+void GLStateCache::bindTexture(unsigned int unit, unsigned int texture, unsigned int target)
+{
+    if (unit >= GL_STATE_TEXTURE_UNITS)
+    {
+        printf("ERROR::STATE_CACHE::TEXTURE_UNIT_OUT_OF_RANGE\nunit %u, only %d are tracked\n", unit, GL_STATE_TEXTURE_UNITS);
+        return;
+    }
+    
+    // Skip the call if the texture is already bound to the unit
+    if (mTextures[unit] == texture)
+    {
+        skippedCalls++;
+        return;
+    }
+    
+    // Only switch the active unit when it is a different one
+    if (unit != mActiveUnit)
+    {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        mActiveUnit = unit;
+    }
+    
+    glBindTexture(target, texture);
+    mTextures[unit] = texture;
+    textureChanges++;
+}
+
+void GLStateCache::setUniform(const char* name, int value)
+{
+    int location = getUniformLocation(name);
+    float shadow = (float) value;
+    
+    if (uniformChanged(location, &shadow, 1))
+        glUniform1i(location, value);
+}
+
+void GLStateCache::setUniform(const char* name, float value)
+{
+    int location = getUniformLocation(name);
+    
+    if (uniformChanged(location, &value, 1))
+        glUniform1f(location, value);
+}
+
+void GLStateCache::setUniform(const char* name, const glm::vec3 &value)
+{
+    int location = getUniformLocation(name);
+    
+    if (uniformChanged(location, glm::value_ptr(value), 3))
+        glUniform3fv(location, 1, glm::value_ptr(value));
+}
+
+void GLStateCache::setUniform(const char* name, const glm::mat4 &value)
+{
+    int location = getUniformLocation(name);
+    
+    if (uniformChanged(location, glm::value_ptr(value), 16))
+        glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(value));
+}
+
+void GLStateCache::invalidate()
+{
+    // Nothing is known to be bound, so the next bind of anything (0 included) will go through
+    mProgram = GL_STATE_UNKNOWN;
+    mVAO = GL_STATE_UNKNOWN;
+    mActiveUnit = GL_STATE_UNKNOWN;
+    for (unsigned int &texture : mTextures)
+        texture = GL_STATE_UNKNOWN;
+    
+    // Programs may have been relinked or their names reused, so cached locations and values can no longer be trusted
+    mLocations.clear();
+    mUniformValues.clear();
+}
+
+void GLStateCache::resetStats()
+{
+    programChanges = vaoChanges = textureChanges = uniformUploads = skippedCalls = 0;
+}
+
+int GLStateCache::getUniformLocation(const char* name)
+{
+    // Uniforms set before any program is used have nowhere to go
+    if (mProgram == GL_STATE_UNKNOWN)
+        return -1;
+    
+    // Looks the name up in the current program's location table
+    std::unordered_map<std::string, int> &locations = mLocations[mProgram];
+    auto found = locations.find(name);
+    if (found != locations.end())
+        return found->second;
+    
+    // Query GL only the first time a name is used
+    int location = glGetUniformLocation(mProgram, name);
+    locations.emplace(name, location);
+    
+    return location;
+}
+
+bool GLStateCache::uniformChanged(int location, const float* value, unsigned int size)
+{
+    // Uniforms that do not exist in the program are never uploaded
+    if (location < 0)
+    {
+        skippedCalls++;
+        return false;
+    }
+    
+    // Finds the shadow copy for this program and location
+    std::vector<float> &shadow = mUniformValues[((uint64_t) mProgram << 32) | (uint32_t) location];
+    
+    // Nothing to upload if the value is identical to the last one
+    if (shadow.size() == size && memcmp(shadow.data(), value, size * sizeof(float)) == 0)
+    {
+        skippedCalls++;
+        return false;
+    }
+    
+    shadow.assign(value, value + size);
+    uniformUploads++;
+    
+    return true;
+}
+
+RenderQueue::RenderQueue(ShaderVariants &shaders, float farPlane) : mShaders(shaders), mFarPlane(farPlane), mSorted(true)
+{
+}
+
+uint64_t RenderQueue::makeKey(RenderPass pass, ShaderFeatures features, unsigned int texture, unsigned int VAO, float depth)
+{
+    // Quantizes the normalized depth into the key's depth bits
+    uint64_t quantized = (uint64_t) (glm::clamp(depth, 0.0f, 1.0f) * KEY_DEPTH_MAX);
+    
+    // State portion of the key, GL names are small so only their low bits are kept
+    uint64_t state = (((uint64_t) features & KEY_ID_MASK) << (2 * KEY_ID_BITS)) | (((uint64_t) texture & KEY_ID_MASK) << KEY_ID_BITS) | ((uint64_t) VAO & KEY_ID_MASK);
+    
+    uint64_t key = (uint64_t) pass << (64 - KEY_PASS_BITS);
+    
+    if (pass == PASS_OPAQUE)
+        // Groups by state first, then draws front to back within a state to cut overdraw
+        key |= (state << KEY_DEPTH_BITS) | quantized;
+    else
+        // Blended draws must be back to front, so depth outranks state
+        key |= ((KEY_DEPTH_MAX - quantized) << (3 * KEY_ID_BITS)) | state;
+    
+    return key;
+}
+
+void RenderQueue::submit(RenderPass pass, ShaderFeatures features, unsigned int VAO, unsigned int count, const glm::mat4 &model, float depth, unsigned int texture, bool indexed)
+{
+    mItems.push_back(DrawItem{model, features, VAO, texture, count, indexed});
+    mKeys.push_back(makeKey(pass, features, texture, VAO, depth / mFarPlane));
+    mSorted = false;
+}
+
+void RenderQueue::prepareShaders()
+{
+    // Asking for a variant compiles it the first time
+    for (const DrawItem &item : mItems)
+        mShaders.get(item.features);
+}
+
+void RenderQueue::sort()
+{
+    if (mSorted)
+        return;
+    
+    // Sorts a copy of the keys so that mKeys stays parallel to mItems
+    mSortKeys.assign(mKeys.begin(), mKeys.end());
+    
+    // The order array starts as the submission order
+    mOrder.resize(mItems.size());
+    for (uint32_t i = 0; i < mOrder.size(); i++)
+        mOrder[i] = i;
+    
+    radixSort();
+    mSorted = true;
+}
+
+void RenderQueue::flush(GLStateCache &cache)
+{
+    sort();
+    
+    for (uint32_t index : mOrder)
+    {
+        const DrawItem &item = mItems[index];
+        
+        // The cache drops every bind and upload that would not change anything
+        cache.useProgram(mShaders.get(item.features).ID);
+        cache.bindVertexArray(item.VAO);
+        if (item.texture != 0)
+            cache.bindTexture(0, item.texture);
+        cache.setUniform("model", item.model);
+        
+        if (item.indexed)
+            glDrawElements(GL_TRIANGLES, item.count, GL_UNSIGNED_INT, (void*) 0);
+        else
+            glDrawArrays(GL_TRIANGLES, 0, item.count);
+    }
+    
+    clear();
+}
+
+void RenderQueue::clear()
+{
+    // Keeps the capacity so that steady state frames do not allocate
+    mItems.clear();
+    mKeys.clear();
+    mOrder.clear();
+    mSorted = true;
+}
+
+size_t RenderQueue::size() const
+{
+    return mItems.size();
+}
+
+void RenderQueue::radixSort()
+{
+    size_t count = mSortKeys.size();
+    if (count < 2)
+        return;
+    
+    mKeyScratch.resize(count);
+    mOrderScratch.resize(count);
+    
+    // Builds the histograms for all eight byte digits in a single pass over the keys
+    uint32_t histograms[8][256];
+    memset(histograms, 0, sizeof(histograms));
+    for (uint64_t key : mSortKeys)
+        for (int digit = 0; digit < 8; digit++)
+            histograms[digit][(key >> (digit * 8)) & 0xFF]++;
+    
+    for (int digit = 0; digit < 8; digit++)
+    {
+        uint32_t* histogram = histograms[digit];
+        
+        // A digit where every key lands in the same bucket would not reorder anything
+        if (histogram[(mSortKeys[0] >> (digit * 8)) & 0xFF] == count)
+            continue;
+        
+        // Turns the counts into starting offsets
+        uint32_t offset = 0;
+        for (int bucket = 0; bucket < 256; bucket++)
+        {
+            uint32_t bucketCount = histogram[bucket];
+            histogram[bucket] = offset;
+            offset += bucketCount;
+        }
+        
+        // Stable scatter into the scratch arrays
+        for (size_t i = 0; i < count; i++)
+        {
+            uint32_t destination = histogram[(mSortKeys[i] >> (digit * 8)) & 0xFF]++;
+            mKeyScratch[destination] = mSortKeys[i];
+            mOrderScratch[destination] = mOrder[i];
+        }
+        
+        mSortKeys.swap(mKeyScratch);
+        mOrder.swap(mOrderScratch);
+    }
+}
@@ -0,0 +1,141 @@
+//
+//  renderqueue.hpp
+//  SnakeGL
+//
+//  Created by Keegan Bilodeau on 10/19/26.
+//  Copyright © 2026 Keegan Bilodeau. All rights reserved.
+//
+
+#ifndef renderqueue_hpp
+#define renderqueue_hpp
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "shadervariants.hpp"
+
+// Passes are drawn in ascending order
+enum RenderPass
+{
+    PASS_OPAQUE = 0,
+    PASS_TRANSPARENT = 1,
+    PASS_OVERLAY = 2
+};
+
+// A single draw call waiting in the render queue
+struct DrawItem
+{
+    // Model matrix uploaded before the draw
+    glm::mat4 model;
+    
+    // Shader features the draw uses, and the GL objects it needs bound
+    ShaderFeatures features;
+    unsigned int VAO, texture;
+    
+    // Number of indices (or vertices when not indexed) to draw
+    unsigned int count;
+    bool indexed;
+};
+
+// Texture units the state cache tracks, and the value of shadowed state that has to be rebound
+const int GL_STATE_TEXTURE_UNITS = 16;
+const unsigned int GL_STATE_UNKNOWN = ~0u;
+
+// Shadows the GL state so that redundant binds and uniform uploads are skipped
+class GLStateCache
+{
+public:
+    GLStateCache();
+    
+    // Binds the program, vertex array or texture only if it is not already bound
+    // Only one texture is tracked per unit, so a unit should always be used with the same target, and
+    // units past GL_STATE_TEXTURE_UNITS are reported and not bound
+    void useProgram(unsigned int program);
+    void bindVertexArray(unsigned int VAO);
+    void bindTexture(unsigned int unit, unsigned int texture, unsigned int target = GL_TEXTURE_2D);
+    
+    // Sets a uniform on the current program only if the value changed since the last upload
+    void setUniform(const char* name, int value);
+    void setUniform(const char* name, float value);
+    void setUniform(const char* name, const glm::vec3 &value);
+    void setUniform(const char* name, const glm::mat4 &value);
+    
+    // Forgets all shadowed state (call after GL state was changed outside the cache)
+    void invalidate();
+    
+    // Counters for state changes that were issued or skipped, reset with resetStats
+    unsigned int programChanges, vaoChanges, textureChanges, uniformUploads, skippedCalls;
+    void resetStats();
+
+private:
+    // Looks up (and caches) a uniform location in the current program
+    int getUniformLocation(const char* name);
+    
+    // Compares a value against the shadow copy for a uniform and updates it, returns true if it changed
+    bool uniformChanged(int location, const float* value, unsigned int size);
+    
+    // Currently bound objects, GL_STATE_UNKNOWN until the first bind after an invalidate
+    unsigned int mProgram, mVAO, mActiveUnit;
+    unsigned int mTextures[GL_STATE_TEXTURE_UNITS];
+    
+    // Uniform locations per program
+    std::unordered_map<unsigned int, std::unordered_map<std::string, int>> mLocations;
+    
+    // Last uploaded value of every uniform, keyed by program and location
+    std::unordered_map<uint64_t, std::vector<float>> mUniformValues;
+};
+
+// Collects draw items each frame, sorts them by a 64 bit key and submits them through a GLStateCache
+// Every draw is made with the variant of the queue's shaders that has exactly the draw's features
+class RenderQueue
+{
+public:
+    // farPlane is used to quantize depth into the sort key
+    RenderQueue(ShaderVariants &shaders, float farPlane = 1000.0f);
+    
+    // Builds the sort key for a draw, each feature mask is one variant so grouping by it groups by program
+    // Opaque: pass | features | texture | VAO | depth (front to back)
+    // Transparent and overlay: pass | inverted depth (back to front) | features | texture | VAO
+    static uint64_t makeKey(RenderPass pass, ShaderFeatures features, unsigned int texture, unsigned int VAO, float depth);
+    
+    // Adds a draw to the queue, depth is the distance from the camera
+    // Safe to call from any thread, variants are only looked up once the queue reaches the GL context
+    void submit(RenderPass pass, ShaderFeatures features, unsigned int VAO, unsigned int count, const glm::mat4 &model, float depth, unsigned int texture = 0, bool indexed = true);
+    
+    // Compiles the variants the queued draws need that were never used before
+    // Call from the context's thread before the frame's uniforms are set on the compiled variants
+    void prepareShaders();
+    
+    // Sorts the queued draws by key
+    void sort();
+    
+    // Issues every queued draw in sorted order and empties the queue
+    void flush(GLStateCache &cache);
+    
+    // Empties the queue without drawing
+    void clear();
+    
+    // Returns the number of queued draws
+    size_t size() const;
+
+private:
+    // Least significant digit radix sort of mSortKeys, carrying mOrder along
+    void radixSort();
+    
+    ShaderVariants &mShaders;
+    float mFarPlane;
+    bool mSorted;
+    
+    // Draw data and the parallel key and order arrays used for sorting
+    std::vector<DrawItem> mItems;
+    std::vector<uint64_t> mKeys, mSortKeys, mKeyScratch;
+    std::vector<uint32_t> mOrder, mOrderScratch;
+};
+
+#endif /* renderqueue_hpp */
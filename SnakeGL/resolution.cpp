@@ -0,0 +1,281 @@
+//
+//  resolution.cpp
+//  SnakeGL
+//
+//  Created by Keegan Bilodeau on 10/19/26.
+//  Copyright © 2026 Keegan Bilodeau. All rights reserved.
+//
+
+#include "resolution.hpp"
+#include "memory.hpp"
+
+#include <math.h>
+#include <chrono>
+#include <algorithm>
+
+#include <glad/glad.h>
+
+// The scale drops once the smoothed scene time is above the budget by this factor, and rises once it
+// is below this fraction of it, for the given number of frames in a row
+const float RESOLUTION_OVER_BUDGET = 1.05f, RESOLUTION_UNDER_BUDGET = 0.75f;
+const int RESOLUTION_FRAMES_DOWN = 8, RESOLUTION_FRAMES_UP = 45;
+
+// Step taken when scaling back up, drops go straight for the budget instead
+const float RESOLUTION_STEP_UP = 0.05f;
+
+// Seconds on a monotonic clock
+static double now()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+ResolutionScaler::ResolutionScaler(float budgetMs, float minScale, float maxScale) : mBudget(budgetMs), mMinScale(minScale), mMaxScale(maxScale), mScale(maxScale), mSceneTime(0.0f), mFramesOver(0), mFramesUnder(0), mWindowWidth(0), mWindowHeight(0), mRenderWidth(0), mRenderHeight(0), mOffscreen(false), mFramebuffer(0), mColorTexture(0), mDepthBuffer(0), mTargetWidth(0), mTargetHeight(0), mQueries{}, mQueryPending{}, mQueryIndex(0), mTimerQueries(false), mCpuStart(0.0)
+{
+}
+
+ResolutionScaler::~ResolutionScaler()
+{
+    MemoryRegistry &registry = MemoryRegistry::get();
+    
+    if (mTimerQueries)
+    {
+        registry.destroyGL(GL_OBJECT_QUERY, mQueries, RESOLUTION_QUERY_COUNT);
+        glDeleteQueries(RESOLUTION_QUERY_COUNT, mQueries);
+    }
+    
+    if (mFramebuffer == 0)
+        return;
+    
+    registry.destroyGL(GL_OBJECT_FRAMEBUFFER, &mFramebuffer, 1);
+    registry.destroyGL(GL_OBJECT_TEXTURE, &mColorTexture, 1);
+    registry.destroyGL(GL_OBJECT_RENDERBUFFER, &mDepthBuffer, 1);
+    glDeleteFramebuffers(1, &mFramebuffer);
+    glDeleteTextures(1, &mColorTexture);
+    glDeleteRenderbuffers(1, &mDepthBuffer);
+}
+
+void ResolutionScaler::initGPU()
+{
+    // GL_TIME_ELAPSED queries are core since 3.3
+    mTimerQueries = GLAD_GL_VERSION_3_3;
+    if (mTimerQueries)
+    {
+        glGenQueries(RESOLUTION_QUERY_COUNT, mQueries);
+        MemoryRegistry::get().createGL(GL_OBJECT_QUERY, mQueries, RESOLUTION_QUERY_COUNT, MEMORY_RENDER_TARGETS);
+    }
+}
+
+bool ResolutionScaler::prepare(int windowWidth, int windowHeight)
+{
+    // A minimized window has an empty framebuffer, the scene keeps the last real size until it comes back
+    if (windowWidth > 0 && windowHeight > 0)
+    {
+        mWindowWidth = windowWidth;
+        mWindowHeight = windowHeight;
+    }
+    windowWidth = std::max(1, mWindowWidth);
+    windowHeight = std::max(1, mWindowHeight);
+    
+    // Collects every finished query, oldest first
+    if (mTimerQueries)
+    {
+        for (int i = 1; i <= RESOLUTION_QUERY_COUNT; i++)
+        {
+            int slot = (mQueryIndex + i) % RESOLUTION_QUERY_COUNT;
+            if (!mQueryPending[slot])
+                continue;
+            
+            int available = 0;
+            glGetQueryObjectiv(mQueries[slot], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available)
+                continue;
+            
+            GLuint64 elapsed = 0;
+            glGetQueryObjectui64v(mQueries[slot], GL_QUERY_RESULT, &elapsed);
+            mQueryPending[slot] = false;
+            addSample((float) (elapsed / 1.0e6));
+        }
+    }
+    
+    // Targets follow the window, a frame whose framebuffer failed is drawn at full scale and the next one tries again
+    bool resized = windowWidth != mTargetWidth || windowHeight != mTargetHeight, complete = true;
+    if (resized && !createTargets(windowWidth, windowHeight))
+    {
+        mTargetWidth = mTargetHeight = 0;
+        complete = false;
+    }
+    
+    mOffscreen = complete && mScale < 1.0f;
+    mRenderWidth = mOffscreen ? std::max(1, (int) (windowWidth * mScale + 0.5f)) : windowWidth;
+    mRenderHeight = mOffscreen ? std::max(1, (int) (windowHeight * mScale + 0.5f)) : windowHeight;
+    
+    return resized;
+}
+
+void ResolutionScaler::begin()
+{
+    // A GPU that is more than a whole ring behind simply leaves this frame untimed
+    if (mTimerQueries)
+    {
+        if (!mQueryPending[mQueryIndex])
+            glBeginQuery(GL_TIME_ELAPSED, mQueries[mQueryIndex]);
+    }
+    else
+        mCpuStart = now();
+    
+    // The scissor keeps clears from touching the unused part of the target
+    glBindFramebuffer(GL_FRAMEBUFFER, mOffscreen ? mFramebuffer : 0);
+    glViewport(0, 0, mRenderWidth, mRenderHeight);
+    if (mOffscreen)
+    {
+        glScissor(0, 0, mRenderWidth, mRenderHeight);
+        glEnable(GL_SCISSOR_TEST);
+    }
+}
+
+void ResolutionScaler::end()
+{
+    if (mTimerQueries)
+    {
+        if (!mQueryPending[mQueryIndex])
+        {
+            glEndQuery(GL_TIME_ELAPSED);
+            mQueryPending[mQueryIndex] = true;
+            mQueryIndex = (mQueryIndex + 1) % RESOLUTION_QUERY_COUNT;
+        }
+    }
+    else
+    {
+        // Without timer queries the wait for the rasterizer has to be part of the measurement
+        glFinish();
+        addSample((float) ((now() - mCpuStart) * 1000.0));
+    }
+    
+    // Stretches the rendered part of the target over the window
+    if (mOffscreen)
+    {
+        glDisable(GL_SCISSOR_TEST);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, mFramebuffer);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+        glBlitFramebuffer(0, 0, mRenderWidth, mRenderHeight, 0, 0, mWindowWidth, mWindowHeight, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+    
+    glViewport(0, 0, mWindowWidth, mWindowHeight);
+}
+
+int ResolutionScaler::getRenderWidth() const
+{
+    return mRenderWidth;
+}
+
+int ResolutionScaler::getRenderHeight() const
+{
+    return mRenderHeight;
+}
+
+float ResolutionScaler::getScale() const
+{
+    return mScale;
+}
+
+float ResolutionScaler::getBudget() const
+{
+    return mBudget;
+}
+
+float ResolutionScaler::getSceneTime() const
+{
+    return mSceneTime;
+}
+
+void ResolutionScaler::setBudget(float budgetMs)
+{
+    mBudget = budgetMs;
+    mFramesOver = mFramesUnder = 0;
+}
+
+bool ResolutionScaler::usesTimerQueries() const
+{
+    return mTimerQueries;
+}
+
+bool ResolutionScaler::createTargets(int width, int height)
+{
+    mTargetWidth = width;
+    mTargetHeight = height;
+    
+    if (mFramebuffer == 0)
+    {
+        glGenFramebuffers(1, &mFramebuffer);
+        glGenTextures(1, &mColorTexture);
+        glGenRenderbuffers(1, &mDepthBuffer);
+        MemoryRegistry::get().createGL(GL_OBJECT_FRAMEBUFFER, &mFramebuffer, 1, MEMORY_RENDER_TARGETS);
+        MemoryRegistry::get().createGL(GL_OBJECT_TEXTURE, &mColorTexture, 1, MEMORY_RENDER_TARGETS);
+        MemoryRegistry::get().createGL(GL_OBJECT_RENDERBUFFER, &mDepthBuffer, 1, MEMORY_RENDER_TARGETS);
+    }
+    
+    // Linear filtering is only used by the blit, the texture is never sampled
+    glBindTexture(GL_TEXTURE_2D, mColorTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    MemoryRegistry::get().resizeGL(GL_OBJECT_TEXTURE, mColorTexture, MemoryRegistry::textureBytes(width, height, 4));
+    
+    glBindRenderbuffer(GL_RENDERBUFFER, mDepthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    MemoryRegistry::get().resizeGL(GL_OBJECT_RENDERBUFFER, mDepthBuffer, MemoryRegistry::textureBytes(width, height, 4));
+    
+    glBindFramebuffer(GL_FRAMEBUFFER, mFramebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, mColorTexture, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, mDepthBuffer);
+    
+    bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (!complete)
+    {
+        puts("ERROR::RESOLUTION::FRAMEBUFFER_INCOMPLETE");
+        return false;
+    }
+    
+    return true;
+}
+
+void ResolutionScaler::addSample(float sceneMs)
+{
+    mSceneTime = mSceneTime > 0.0f ? mSceneTime * 0.9f + sceneMs * 0.1f : sceneMs;
+    
+    // Frames inside the band between the two thresholds reset both counts
+    if (mSceneTime > mBudget * RESOLUTION_OVER_BUDGET)
+    {
+        mFramesOver++;
+        mFramesUnder = 0;
+    }
+    else if (mSceneTime < mBudget * RESOLUTION_UNDER_BUDGET)
+    {
+        mFramesUnder++;
+        mFramesOver = 0;
+    }
+    else
+        mFramesOver = mFramesUnder = 0;
+    
+    float scale = mScale;
+    if (mFramesOver >= RESOLUTION_FRAMES_DOWN)
+    {
+        // Fill cost follows the pixel count, which is the square of the scale
+        scale = mScale * sqrtf(mBudget * 0.9f / mSceneTime);
+    }
+    else if (mFramesUnder >= RESOLUTION_FRAMES_UP)
+        scale = mScale + RESOLUTION_STEP_UP;
+    else
+        return;
+    
+    scale = std::min(mMaxScale, std::max(mMinScale, scale));
+    
+    // Predicts the time at the new scale so the average does not keep pushing in the same direction
+    mSceneTime *= (scale * scale) / (mScale * mScale);
+    mScale = scale;
+    mFramesOver = mFramesUnder = 0;
+}
@@ -0,0 +1,91 @@
+//
+//  resolution.hpp
+//  SnakeGL
+//
+//  Created by Keegan Bilodeau on 10/19/26.
+//  Copyright © 2026 Keegan Bilodeau. All rights reserved.
+//
+
+#ifndef resolution_hpp
+#define resolution_hpp
+
+#include <stdio.h>
+
+// Number of timer queries in flight, results are read a few frames late so the CPU never waits on them
+const int RESOLUTION_QUERY_COUNT = 4;
+
+// Renders the scene into an offscreen framebuffer whose size follows a frame time budget, then
+// stretches it over the window with a linear blit
+// Scene render time comes from GL timer queries, or from CPU timing of the render around a glFinish
+// when timer queries are unavailable. The scale only moves after several frames in a row land
+// outside the budget's band, so it does not flicker around the budget
+class ResolutionScaler
+{
+public:
+    // budgetMs is the scene render time to hold, the scale stays within [minScale, maxScale]
+    ResolutionScaler(float budgetMs = 12.0f, float minScale = 0.5f, float maxScale = 1.0f);
+    ~ResolutionScaler();
+    
+    // Creates the timer queries, the framebuffer is created on the first begin
+    // Needs a current GL context
+    void initGPU();
+    
+    // Reads finished timings and picks this frame's render size, call before getRenderWidth/Height
+    // An empty window (while minimized) keeps the previous size, so the render size is never zero
+    // Returns true if the targets were recreated for a new window size, which rebinds the active
+    // texture unit, so a GLStateCache must be invalidated afterwards
+    bool prepare(int windowWidth, int windowHeight);
+    
+    // Starts the scene, binding the offscreen framebuffer and setting the viewport to the render size
+    // At full scale the scene is drawn straight into the window instead
+    void begin();
+    
+    // Ends the scene, blits it over the whole window and feeds the timing back into the scale
+    // Leaves the default framebuffer bound with a full window viewport
+    void end();
+    
+    // Size the scene is rendered at this frame
+    int getRenderWidth() const;
+    int getRenderHeight() const;
+    
+    // Current scale of each axis, the budget and the smoothed scene time in milliseconds
+    float getScale() const;
+    float getBudget() const;
+    float getSceneTime() const;
+    void setBudget(float budgetMs);
+    
+    // True if scene times come from GL timer queries
+    bool usesTimerQueries() const;
+
+private:
+    // (Re)creates the offscreen targets at the window size
+    bool createTargets(int width, int height);
+    
+    // Adds one scene time sample and moves the scale if needed
+    void addSample(float sceneMs);
+    
+    float mBudget, mMinScale, mMaxScale, mScale;
+    
+    // Exponential moving average of the scene time, and frames spent above or below the band
+    float mSceneTime;
+    int mFramesOver, mFramesUnder;
+    
+    // Window and render sizes of the current frame, and whether it goes through the offscreen target
+    int mWindowWidth, mWindowHeight, mRenderWidth, mRenderHeight;
+    bool mOffscreen;
+    
+    // Offscreen targets, allocated at the full window size so that scale changes never reallocate
+    unsigned int mFramebuffer, mColorTexture, mDepthBuffer;
+    int mTargetWidth, mTargetHeight;
+    
+    // Timer query ring, frames are only written once their query result has been read
+    unsigned int mQueries[RESOLUTION_QUERY_COUNT];
+    bool mQueryPending[RESOLUTION_QUERY_COUNT];
+    int mQueryIndex;
+    bool mTimerQueries;
+    
+    // Start of the CPU timed scene when timer queries are unavailable
+    double mCpuStart;
+};
+
+#endif /* resolution_hpp */
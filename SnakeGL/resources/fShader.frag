@@ -1,17 +1,71 @@
 #version 330 core
+// Compiled as variants, see ShaderVariants: TEXTURED, INSTANCED, LIT and FOG are defined as needed
 out vec4 FragColor;
 
 in vec3 VertexColor;
+#ifdef LIT
 in vec3 Normal;
+in vec3 FragPos;
+#endif
+#ifdef TEXTURED
 in vec2 TexCoords;
 
-in vec3 FragPos;
+uniform sampler2D diffuseTexture;
+#endif
+#ifdef FOG
+in float FogDepth;
+
+// Exponential squared fog
+uniform vec3 fogColor;
+uniform float fogDensity;
+#endif
 
+#ifdef LIT
 uniform vec3 lightColor;
 uniform vec3 lightPos;
 
+// Culled point lights, two texels per light: position and radius, then color
+uniform samplerBuffer lightData;
+// First index and count of every screen tile's lights, and the shared index list
+uniform usamplerBuffer tileLights;
+uniform usamplerBuffer lightIndices;
+uniform int tileSize;
+uniform int tilesX;
+
+// Sums the point lights whose bounds overlap this fragment's tile
+vec3 pointLights(vec3 normal)
+{
+    ivec2 tile = ivec2(gl_FragCoord.xy) / max(tileSize, 1);
+    uvec2 range = texelFetch(tileLights, tile.y * tilesX + tile.x).xy;
+    
+    vec3 result = vec3(0.0);
+    for (uint i = 0u; i < range.y; i++)
+    {
+        int light = int(texelFetch(lightIndices, int(range.x + i)).r);
+        vec4 positionRadius = texelFetch(lightData, light * 2);
+        vec3 color = texelFetch(lightData, light * 2 + 1).rgb;
+        
+        vec3 toLight = positionRadius.xyz - FragPos;
+        float distance = length(toLight);
+        
+        // Smooth falloff that reaches zero exactly at the radius the light was culled with
+        float falloff = clamp(1.0 - distance * distance / (positionRadius.w * positionRadius.w), 0.0, 1.0);
+        float diff = max(dot(normal, toLight / max(distance, 0.0001)), 0.0);
+        result += diff * falloff * falloff * color;
+    }
+    
+    return result;
+}
+#endif
+
 void main()
 {
+    vec3 color = VertexColor;
+#ifdef TEXTURED
+    color *= texture(diffuseTexture, TexCoords).rgb;
+#endif
+    
+#ifdef LIT
     float ambientStrength = 0.1;
     vec3 ambient = ambientStrength * lightColor;
     
@@ -21,6 +75,15 @@ void main()
     float diff = max(dot(normal, lightDir), 0.0);
     vec3 diffuse = diff * lightColor;
     
-    vec3 result = (diffuse + ambient) * VertexColor;
+    vec3 result = (diffuse + ambient + pointLights(normal)) * color;
+#else
+    vec3 result = color;
+#endif
+    
+#ifdef FOG
+    float fog = exp(-fogDensity * fogDensity * FogDepth * FogDepth);
+    result = mix(fogColor, result, clamp(fog, 0.0, 1.0));
+#endif
+    
     FragColor = vec4(result, 1.0);
 }
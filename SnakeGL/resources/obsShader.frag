@@ -0,0 +1,9 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec3 CellColor;
+
+void main()
+{
+    FragColor = vec4(CellColor, 1.0);
+}
@@ -0,0 +1,24 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 4) in vec4 aInstance;
+
+out vec3 CellColor;
+
+// Tiles per atlas row, tiles per atlas column, and the size of one cell in tile space
+uniform vec2 atlasTiles;
+uniform vec2 cellSize;
+uniform vec3 palette[4];
+
+void main()
+{
+    // aInstance holds the tile index, the cell's position in tile space, and its palette entry
+    float tile = aInstance.x;
+    vec2 tileOrigin = vec2(mod(tile, atlasTiles.x), floor(tile / atlasTiles.x));
+    
+    // The quad spans -0.5 to 0.5, so scaling by the cell size covers exactly one cell
+    vec2 tilePos = aInstance.yz + aPos.xy * cellSize;
+    vec2 atlasPos = (tileOrigin + tilePos) / atlasTiles;
+    
+    gl_Position = vec4(atlasPos * 2.0 - 1.0, 0.0, 1.0);
+    CellColor = palette[int(aInstance.w)];
+}
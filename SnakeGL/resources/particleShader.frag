@@ -0,0 +1,12 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 Corner;
+in vec4 ParticleColor;
+
+void main()
+{
+    // Soft round particles, the quad corners run from -0.5 to 0.5
+    float falloff = 1.0 - smoothstep(0.2, 0.5, length(Corner));
+    FragColor = vec4(ParticleColor.rgb, ParticleColor.a * falloff);
+}
@@ -0,0 +1,35 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 4) in float aX;
+layout (location = 5) in float aY;
+layout (location = 6) in float aZ;
+layout (location = 7) in float aLife;
+layout (location = 8) in vec4 aColor;
+
+out vec2 Corner;
+out vec4 ParticleColor;
+
+uniform mat4 view;
+uniform mat4 projection;
+uniform float particleSize;
+
+void main()
+{
+    // Dead particles are moved outside of clip space so they produce no fragments
+    if (aLife <= 0.0)
+    {
+        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+        return;
+    }
+    
+    // The camera's right and up vectors are the first two rows of the view matrix
+    vec3 right = vec3(view[0][0], view[1][0], view[2][0]);
+    vec3 up = vec3(view[0][1], view[1][1], view[2][1]);
+    vec3 position = vec3(aX, aY, aZ) + (right * aPos.x + up * aPos.y) * particleSize;
+    
+    gl_Position = projection * view * vec4(position, 1.0);
+    Corner = aPos.xy;
+    
+    // Fades out over the last half second of life
+    ParticleColor = vec4(aColor.rgb, aColor.a * clamp(aLife * 2.0, 0.0, 1.0));
+}
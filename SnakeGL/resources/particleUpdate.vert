@@ -0,0 +1,33 @@
+#version 330 core
+layout (location = 0) in vec3 aPosition;
+layout (location = 1) in vec3 aVelocity;
+layout (location = 2) in float aLife;
+layout (location = 3) in uint aColor;
+
+// Captured with transform feedback in the same interleaved layout as the input
+out vec3 outPosition;
+out vec3 outVelocity;
+out float outLife;
+flat out uint outColor;
+
+uniform float deltaTime;
+uniform vec3 gravity;
+
+void main()
+{
+    outColor = aColor;
+    
+    // Dead slots stay as they are until the ring reuses them
+    if (aLife <= 0.0)
+    {
+        outPosition = aPosition;
+        outVelocity = aVelocity;
+        outLife = aLife;
+        return;
+    }
+    
+    // Same semi implicit Euler step as the CPU path
+    outVelocity = aVelocity + gravity * deltaTime;
+    outPosition = aPosition + outVelocity * deltaTime;
+    outLife = aLife - deltaTime;
+}
@@ -0,0 +1,13 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoords;
+in vec4 TextColor;
+
+// Single channel glyph coverage
+uniform sampler2D glyphAtlas;
+
+void main()
+{
+    FragColor = vec4(TextColor.rgb, TextColor.a * texture(glyphAtlas, TexCoords).r);
+}
@@ -1,24 +1,51 @@
 #version 330 core
+// Compiled as variants, see ShaderVariants: TEXTURED, INSTANCED, LIT and FOG are defined as needed
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec3 aColor;
+#ifdef TEXTURED
 layout (location = 3) in vec2 aTexCoords;
+#endif
+#ifdef INSTANCED
+// Per instance model matrix, takes up locations 4 to 7
+layout (location = 4) in mat4 aModel;
+#endif
 
 out vec3 VertexColor;
+#ifdef LIT
 out vec3 Normal;
-out vec2 TexCoords;
-
 out vec3 FragPos;
+#endif
+#ifdef TEXTURED
+out vec2 TexCoords;
+#endif
+#ifdef FOG
+out float FogDepth;
+#endif
 
+#ifndef INSTANCED
 uniform mat4 model;
+#endif
 uniform mat4 view;
 uniform mat4 projection;
 
 void main()
 {
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
-    FragPos = vec3(model * vec4(aPos, 1.0f));
+#ifdef INSTANCED
+    mat4 model = aModel;
+#endif
+    vec4 worldPos = model * vec4(aPos, 1.0);
+    vec4 viewPos = view * worldPos;
+    gl_Position = projection * viewPos;
     VertexColor = aColor;
+#ifdef LIT
+    FragPos = vec3(worldPos);
     Normal = mat3(transpose(inverse(model))) * aNormal;
+#endif
+#ifdef TEXTURED
     TexCoords = aTexCoords;
+#endif
+#ifdef FOG
+    FogDepth = -viewPos.z;
+#endif
 }
@@ -0,0 +1,363 @@
+//
+//  server.cpp
+//  SnakeGL
+//
+//  Created by Keegan Bilodeau on 10/19/26.
+//  Copyright © 2026 Keegan Bilodeau. All rights reserved.
+//
+
+#include "server.hpp"
+#include "memory.hpp"
+
+#include <signal.h>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+
+// Cleared by Ctrl-C to stop the headless server
+static std::atomic<bool> serverRunning(true);
+
+// Seconds on a monotonic clock
+static double now()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+GameServer::GameServer(int width, int height, int maxPlayers, float tickTime, unsigned int seed) : ticks(0), tickSeconds(0.0), maxTickSeconds(0.0), bytesSent(0), bytesReceived(0), snapshotsSent(0), fullSnapshots(0), mBoard(width, height, seed, maxPlayers, maxPlayers * 2), mMaxPlayers(maxPlayers), mTickTime(tickTime), mSeed(seed | 1)
+{
+    // One piece of food per player keeps everyone busy without flooding the arena
+    mBoard.setFoodTarget(maxPlayers);
+    mClients.reserve(maxPlayers);
+    
+    reportMemory();
+}
+
+GameServer::~GameServer()
+{
+    // Tells every client that the server is gone instead of letting them time out
+    for (const ServerClient &client : mClients)
+        sendHeader(client.address, PACKET_DISCONNECT);
+    
+    MemoryRegistry::get().releaseCPU(this);
+}
+
+bool GameServer::start(uint16_t port)
+{
+    return mSocket.open(port);
+}
+
+void GameServer::run(const std::atomic<bool> &running, double reportInterval)
+{
+    auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(mTickTime));
+    auto next = std::chrono::steady_clock::now();
+    double reportStart = now();
+    
+    while (running)
+    {
+        tick();
+        
+        if (reportInterval > 0.0 && now() - reportStart >= reportInterval)
+        {
+            // Traffic per player and second, and how much of the tick budget the server used
+            double seconds = now() - reportStart;
+            int players = std::max(1, getPlayerCount());
+            printf("%d players, %.3f ms/tick (max %.3f), %.0f B/s down and %.0f B/s up per player\n", getPlayerCount(), tickSeconds * 1000.0 / std::max((uint64_t) 1, ticks), maxTickSeconds * 1000.0, bytesSent / seconds / players, bytesReceived / seconds / players);
+            
+            resetStats();
+            reportStart = now();
+        }
+        
+        // A server that fell behind starts counting from now instead of running a burst of late ticks
+        next += period;
+        if (std::chrono::steady_clock::now() > next + period)
+            next = std::chrono::steady_clock::now();
+        
+        std::this_thread::sleep_until(next);
+    }
+}
+
+void GameServer::tick()
+{
+    double start = now();
+    
+    receive();
+    simulate();
+    broadcast();
+    
+    double elapsed = now() - start;
+    tickSeconds += elapsed;
+    maxTickSeconds = std::max(maxTickSeconds, elapsed);
+    ticks++;
+}
+
+void GameServer::receive()
+{
+    uint8_t packet[NET_MAX_PACKET];
+    NetAddress address;
+    
+    int size;
+    while ((size = mSocket.receive(address, packet, sizeof(packet))) >= 0)
+    {
+        bytesReceived += size;
+        handlePacket(address, packet, size);
+    }
+}
+
+void GameServer::simulate()
+{
+    double time = now();
+    
+    // Silent clients are gone, their snakes with them
+    for (size_t client = mClients.size(); client-- > 0;)
+        if (time - mClients[client].lastHeard > SERVER_CLIENT_TIMEOUT)
+            removeClient(client);
+    
+    for (ServerClient &client : mClients)
+    {
+        if (client.snake >= 0 || client.respawnTicks-- > 0)
+            continue;
+        
+        // Tries again next tick if the arena is too crowded right now
+        client.snake = spawnSnake();
+        if (client.snake >= 0)
+            client.lastHead = mBoard.getSnake(client.snake).head;
+    }
+    
+    mBoard.tick();
+    
+    // Snakes only die in the tick, so deaths are noted right away before a new snake can take over a dead one's slot
+    for (ServerClient &client : mClients)
+    {
+        if (client.snake < 0)
+            continue;
+        
+        if (mBoard.getSnake(client.snake).alive)
+            client.lastHead = mBoard.getSnake(client.snake).head;
+        else
+        {
+            client.snake = -1;
+            client.respawnTicks = SERVER_RESPAWN_TICKS;
+        }
+    }
+    
+    reportMemory();
+}
+
+void GameServer::broadcast()
+{
+    uint32_t tick = (uint32_t) mBoard.getTick();
+    
+    for (ServerClient &client : mClients)
+    {
+        // The new view replaces the oldest one, which can no longer be acknowledged usefully
+        NetView &view = client.history[tick % NET_HISTORY_SIZE];
+        view.tick = tick;
+        interestWindow(client.lastHead, view);
+        
+        // The newest acknowledged view is the baseline as long as it is still remembered
+        const NetView* baseline = nullptr;
+        const NetView &acked = client.history[client.ackTick % NET_HISTORY_SIZE];
+        if (client.ackTick != 0 && client.ackTick != tick && acked.tick == client.ackTick)
+            baseline = &acked;
+        
+        mWriter.clear();
+        mWriter.write(NET_PROTOCOL_ID, 32);
+        mWriter.write(PACKET_SNAPSHOT, NET_TYPE_BITS);
+        mWriter.write(tick, 32);
+        mWriter.write(baseline ? baseline->tick : 0, 32);
+        mWriter.write(view.x, 16);
+        mWriter.write(view.y, 16);
+        mWriter.write(view.width, 8);
+        mWriter.write(view.height, 8);
+        
+        // The player's own snake, the window only shows its cells
+        bool alive = client.snake >= 0 && mBoard.getSnake(client.snake).alive;
+        mWriter.write(alive, 1);
+        if (alive)
+        {
+            const Snake &snake = mBoard.getSnake(client.snake);
+            mWriter.write(snake.head % mBoard.getWidth(), 16);
+            mWriter.write(snake.head / mBoard.getWidth(), 16);
+            mWriter.write(snake.direction, 2);
+            mWriter.writeGamma(snake.score + 1);
+            mWriter.writeGamma(snake.length);
+        }
+        
+        writeViewDelta(mWriter, baseline, view);
+        
+        mSocket.send(client.address, mWriter.getData(), mWriter.getSize());
+        bytesSent += mWriter.getSize();
+        snapshotsSent++;
+        fullSnapshots += baseline == nullptr;
+    }
+}
+
+const Board &GameServer::getBoard() const
+{
+    return mBoard;
+}
+
+int GameServer::getPlayerCount() const
+{
+    return (int) mClients.size();
+}
+
+uint16_t GameServer::getPort() const
+{
+    return mSocket.getPort();
+}
+
+float GameServer::getTickTime() const
+{
+    return mTickTime;
+}
+
+void GameServer::resetStats()
+{
+    ticks = 0;
+    tickSeconds = maxTickSeconds = 0.0;
+    bytesSent = bytesReceived = snapshotsSent = fullSnapshots = 0;
+}
+
+void GameServer::handlePacket(const NetAddress &address, const uint8_t* data, size_t size)
+{
+    BitReader reader(data, size);
+    if (reader.read(32) != NET_PROTOCOL_ID)
+        return;
+    
+    PacketType type = (PacketType) reader.read(NET_TYPE_BITS);
+    auto found = std::find_if(mClients.begin(), mClients.end(), [&](const ServerClient &client) { return client.address == address; });
+    
+    if (type == PACKET_CONNECT)
+    {
+        // A repeated connect means the welcome got lost
+        if (found == mClients.end())
+        {
+            if ((int) mClients.size() >= mMaxPlayers)
+            {
+                sendHeader(address, PACKET_REJECT);
+                return;
+            }
+            
+            mClients.emplace_back();
+            found = mClients.end() - 1;
+            found->address = address;
+            found->ackTick = 0;
+            found->respawnTicks = 0;
+            found->snake = spawnSnake();
+            found->lastHead = found->snake >= 0 ? mBoard.getSnake(found->snake).head : (mBoard.getHeight() / 2) * mBoard.getWidth() + mBoard.getWidth() / 2;
+        }
+        found->lastHeard = now();
+        
+        mWriter.clear();
+        mWriter.write(NET_PROTOCOL_ID, 32);
+        mWriter.write(PACKET_WELCOME, NET_TYPE_BITS);
+        mWriter.write(mBoard.getWidth(), 16);
+        mWriter.write(mBoard.getHeight(), 16);
+        mWriter.write((uint32_t) (mTickTime * 1000.0f + 0.5f), 16);
+        mSocket.send(address, mWriter.getData(), mWriter.getSize());
+        bytesSent += mWriter.getSize();
+        return;
+    }
+    
+    // Anything else only means something from a connected client
+    if (found == mClients.end())
+        return;
+    found->lastHeard = now();
+    
+    if (type == PACKET_DISCONNECT)
+    {
+        removeClient(found - mClients.begin());
+        return;
+    }
+    
+    if (type != PACKET_INPUT)
+        return;
+    
+    uint32_t ack = reader.read(32);
+    bool turns = reader.read(1);
+    Direction direction = (Direction) reader.read(2);
+    if (reader.overflowed())
+        return;
+    
+    // Packets can arrive out of order, an older acknowledgement never replaces a newer one
+    found->ackTick = std::max(found->ackTick, ack);
+    if (turns && found->snake >= 0 && mBoard.getSnake(found->snake).alive)
+        mBoard.setDirection(found->snake, direction);
+}
+
+int GameServer::spawnSnake()
+{
+    for (int attempt = 0; attempt < 64; attempt++)
+    {
+        // Xorshift, the same generator the board uses for food
+        mSeed ^= mSeed << 13;
+        mSeed ^= mSeed >> 17;
+        mSeed ^= mSeed << 5;
+        
+        // Keeps new snakes off the edges so they do not start facing a wall
+        int x = 2 + mSeed % std::max(1, mBoard.getWidth() - 4), y = 2 + (mSeed >> 12) % std::max(1, mBoard.getHeight() - 4);
+        int snake = mBoard.addSnake(x, y, (Direction) (mSeed >> 30), 3);
+        if (snake >= 0)
+            return snake;
+    }
+    
+    return -1;
+}
+
+void GameServer::removeClient(size_t client)
+{
+    if (mClients[client].snake >= 0)
+        mBoard.removeSnake(mClients[client].snake);
+    
+    mClients.erase(mClients.begin() + client);
+}
+
+void GameServer::interestWindow(int cell, NetView &view) const
+{
+    int width = mBoard.getWidth(), height = mBoard.getHeight();
+    int centerX = cell % width, centerY = cell / width;
+    
+    view.x = std::max(0, centerX - NET_INTEREST_RADIUS);
+    view.y = std::max(0, centerY - NET_INTEREST_RADIUS);
+    view.width = std::min(width, centerX + NET_INTEREST_RADIUS + 1) - view.x;
+    view.height = std::min(height, centerY + NET_INTEREST_RADIUS + 1) - view.y;
+    
+    view.cells.resize(view.width * view.height);
+    for (int row = 0; row < view.height; row++)
+        for (int column = 0; column < view.width; column++)
+            view.cells[row * view.width + column] = mBoard.getCell((view.y + row) * width + view.x + column);
+}
+
+void GameServer::sendHeader(const NetAddress &address, PacketType type)
+{
+    mWriter.clear();
+    mWriter.write(NET_PROTOCOL_ID, 32);
+    mWriter.write(type, NET_TYPE_BITS);
+    mSocket.send(address, mWriter.getData(), mWriter.getSize());
+    bytesSent += mWriter.getSize();
+}
+
+void GameServer::reportMemory()
+{
+    size_t bytes = mBoard.getStateSize() + mClients.capacity() * sizeof(ServerClient);
+    for (const ServerClient &client : mClients)
+        for (const NetView &view : client.history)
+            bytes += view.cells.capacity();
+    
+    MemoryRegistry::get().setCPU(this, MEMORY_SIMULATION, bytes);
+}
+
+bool runServer(uint16_t port)
+{
+    GameServer server(SERVER_ARENA_SIZE, SERVER_ARENA_SIZE, SERVER_MAX_PLAYERS);
+    if (!server.start(port))
+        return false;
+    
+    signal(SIGINT, [](int) { serverRunning = false; });
+    printf("Serving a %dx%d arena for up to %d players on port %u\n", SERVER_ARENA_SIZE, SERVER_ARENA_SIZE, SERVER_MAX_PLAYERS, server.getPort());
+    
+    server.run(serverRunning, 5.0);
+    
+    return true;
+}
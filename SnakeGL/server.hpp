@@ -0,0 +1,120 @@
+//
+//  server.hpp
+//  SnakeGL
+//
+//  Created by Keegan Bilodeau on 10/19/26.
+//  Copyright © 2026 Keegan Bilodeau. All rights reserved.
+//
+
+#ifndef server_hpp
+#define server_hpp
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include <vector>
+
+#include "board.hpp"
+#include "net.hpp"
+
+// Seconds without a packet before a client is dropped and its snake removed
+const double SERVER_CLIENT_TIMEOUT = 5.0;
+
+// Ticks a dead player waits before its snake is placed again
+const int SERVER_RESPAWN_TICKS = 20;
+
+// Arena used by the headless server mode
+const int SERVER_ARENA_SIZE = 64, SERVER_MAX_PLAYERS = 32;
+
+// Headless, authoritative game server
+// Runs the only simulation of the arena at a fixed tick, takes direction inputs from clients over UDP
+// and sends every client a snapshot of the cells around its own snake after every tick. Snapshots are
+// bit packed deltas against the newest snapshot the client acknowledged, or full snapshots when the
+// client has not acknowledged any that the server still remembers
+class GameServer
+{
+public:
+    GameServer(int width, int height, int maxPlayers, float tickTime = 0.15f, unsigned int seed = 1);
+    ~GameServer();
+    
+    // Opens the server's socket, returns false if the port could not be bound
+    bool start(uint16_t port = NET_DEFAULT_PORT);
+    
+    // Ticks at the fixed rate until running turns false, printing and resetting the stats every reportInterval seconds if it is set
+    void run(const std::atomic<bool> &running, double reportInterval = 0.0);
+    
+    // One whole tick, reads every waiting packet, advances the board and sends the snapshots
+    void tick();
+    
+    // Parts of a tick
+    void receive();
+    void simulate();
+    void broadcast();
+    
+    // The authoritative board, only safe to use from the thread that ticks the server
+    const Board &getBoard() const;
+    
+    // Connected clients and the port the server is bound to
+    int getPlayerCount() const;
+    uint16_t getPort() const;
+    float getTickTime() const;
+    
+    // Zeroes the counters below
+    void resetStats();
+    
+    // Ticks run, time spent in them, and traffic in both directions since the last reset
+    uint64_t ticks;
+    double tickSeconds, maxTickSeconds;
+    uint64_t bytesSent, bytesReceived, snapshotsSent, fullSnapshots;
+
+private:
+    // A connected player, with the snapshots it was sent so that acknowledged ones can be used as baselines
+    struct ServerClient
+    {
+        NetAddress address;
+        int snake;
+        
+        // Newest snapshot tick the client acknowledged, 0 before the first
+        uint32_t ackTick;
+        
+        // Last cell the snake's head was on, the window stays there while it is dead
+        int lastHead;
+        int respawnTicks;
+        double lastHeard;
+        
+        NetView history[NET_HISTORY_SIZE];
+    };
+    
+    // Handles one packet from a peer
+    void handlePacket(const NetAddress &address, const uint8_t* data, size_t size);
+    
+    // Places a snake for a client on a random free spot, returns its index or -1 if no spot was found
+    int spawnSnake();
+    
+    // Drops a client and takes its snake off the board
+    void removeClient(size_t client);
+    
+    // Window of cells around a board cell, clipped to the board
+    void interestWindow(int cell, NetView &view) const;
+    
+    // Sends a packet that only has a header
+    void sendHeader(const NetAddress &address, PacketType type);
+    
+    // Reports the board and the client histories to the memory registry
+    void reportMemory();
+    
+    Board mBoard;
+    int mMaxPlayers;
+    float mTickTime;
+    uint32_t mSeed;
+    
+    UdpSocket mSocket;
+    std::vector<ServerClient> mClients;
+    BitWriter mWriter;
+};
+
+// Runs a headless server on the port until interrupted (SnakeGL --server [port]), returns false if it could not start
+bool runServer(uint16_t port);
+
+#endif /* server_hpp */
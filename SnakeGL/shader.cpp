@@ -7,11 +7,12 @@
 //
 
 #include "shader.hpp"
+#include "memory.hpp"
 
 #include <fstream>
 #include <sstream>
 
-Shader::Shader(const char* vertexPath, const char* fragmentPath)
+Shader::Shader(const char* vertexPath, const char* fragmentPath, const std::string &defines)
 {
     // Temporary strings to hold source code
     std::string vertexCode, fragmentCode;
@@ -20,6 +21,10 @@ Shader::Shader(const char* vertexPath, const char* fragmentPath)
     loadShaderFile(vertexCode, vertexPath);
     loadShaderFile(fragmentCode, fragmentPath);
     
+    // Feature switches for shader variants
+    injectDefines(vertexCode, defines);
+    injectDefines(fragmentCode, defines);
+    
     // Stores the shader source in the apporpriate format
     const char* vShaderCode = vertexCode.c_str();
     const char* fShaderCode = fragmentCode.c_str();
@@ -33,10 +38,41 @@ Shader::Shader(const char* vertexPath, const char* fragmentPath)
     
     // Creates shader program
     ID = glCreateProgram();
+    // Programs are counted but not sized, drivers do not report how much memory they keep
+    MemoryRegistry::get().createGL(GL_OBJECT_PROGRAM, &ID, 1, MEMORY_SHADERS);
     // Attaches both shaders
     glAttachShader(ID, vertexShader);
     glAttachShader(ID, fragmentShader);
     // Connects the program and shaders together
+    linkProgram();
+    
+    // Cleanup
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+}
+
+Shader::Shader(const char* vertexPath, const std::vector<const char*> &feedbackVaryings)
+{
+    // Loads and compiles the vertex shader, there is no fragment stage
+    std::string vertexCode;
+    loadShaderFile(vertexCode, vertexPath);
+    
+    unsigned int vertexShader;
+    loadShader(vertexShader, vertexCode.c_str(), GL_VERTEX_SHADER);
+    
+    ID = glCreateProgram();
+    MemoryRegistry::get().createGL(GL_OBJECT_PROGRAM, &ID, 1, MEMORY_SHADERS);
+    glAttachShader(ID, vertexShader);
+    
+    // The captured outputs have to be named before linking
+    glTransformFeedbackVaryings(ID, (GLsizei) feedbackVaryings.size(), feedbackVaryings.data(), GL_INTERLEAVED_ATTRIBS);
+    linkProgram();
+    
+    glDeleteShader(vertexShader);
+}
+
+void Shader::linkProgram()
+{
     glLinkProgram(ID);
     
     // Linking status check variables
@@ -45,6 +81,7 @@ Shader::Shader(const char* vertexPath, const char* fragmentPath)
     
     // Get the program's linking status and check for failure
     glGetProgramiv(ID, GL_LINK_STATUS, &success);
+    linked = success;
     if (!success)
     {
         // Get program's info log
@@ -52,10 +89,6 @@ Shader::Shader(const char* vertexPath, const char* fragmentPath)
         // Output failure to console
         printf("ERROR::SHADER::PROGRAM::LINKING_FAILED\n%s\n", infoLog);
     }
-    
-    // Cleanup
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
 }
 
 void Shader::loadShader(unsigned int &shader, const char* shaderSource, int shaderType)
@@ -121,6 +154,26 @@ void Shader::loadShaderFile(std::string &shaderCode, const char *filePath)
     }
 }
 
+void Shader::injectDefines(std::string &shaderCode, const std::string &defines)
+{
+    if (defines.empty())
+        return;
+    
+    // #version has to stay the first directive, so the defines go on the line after it
+    size_t version = shaderCode.find("#version");
+    if (version == std::string::npos)
+    {
+        shaderCode.insert(0, defines);
+        return;
+    }
+    
+    size_t lineEnd = shaderCode.find('\n', version);
+    if (lineEnd == std::string::npos)
+        shaderCode += "\n" + defines;
+    else
+        shaderCode.insert(lineEnd + 1, defines);
+}
+
 void Shader::use()
 {
     glUseProgram(ID);
@@ -143,6 +196,12 @@ void Shader::setUniform(const char *name, float value)
     glUniform1f(uniformLoc, value);
 }
 
+void Shader::setUniform(const char *name, float x, float y)
+{
+    int uniformLoc = glGetUniformLocation(ID, name);
+    glUniform2f(uniformLoc, x, y);
+}
+
 void Shader::setUniform(const char *name, float x, float y, float z)
 {
     int uniformLoc = glGetUniformLocation(ID, name);
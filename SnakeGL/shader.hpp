@@ -11,6 +11,7 @@
 
 #include <stdio.h>
 #include <string>
+#include <vector>
 
 #include <glad/glad.h>
 #include <glm/glm.hpp>
@@ -22,8 +23,14 @@ public:
     // ID of the shader program that openGL will use
     unsigned int ID;
     
-    // Creates the shader program
-    Shader(const char* vertexPath, const char* fragmentPath);
+    // False if the program failed to link
+    bool linked;
+    
+    // Creates the shader program, defines is inserted into both stages right after their #version line
+    Shader(const char* vertexPath, const char* fragmentPath, const std::string &defines = "");
+    
+    // Creates a vertex only program whose outputs are captured with transform feedback, interleaved in the given order
+    Shader(const char* vertexPath, const std::vector<const char*> &feedbackVaryings);
     
     // Makes this shader the active shader program
     void use();
@@ -32,16 +39,23 @@ public:
     void setUniform(const char* name, bool value);
     void setUniform(const char* name, int value);
     void setUniform(const char* name, float value);
+    void setUniform(const char* name, float x, float y);
     void setUniform(const char* name, float x, float y, float z);
     void setUniform(const char* name, glm::mat4 value);
     void setUniform(const char* name, glm::vec3 value);
-    
+
 private:
+    // Links the program and reports failure
+    void linkProgram();
+    
     // Loads an individual shader
     void loadShader(unsigned int &shader, const char* shaderSource, int shaderType);
     
     // Loads a shader file
     void loadShaderFile(std::string &shaderCode, const char* filePath);
+    
+    // Inserts lines after the #version directive (or at the top if there is none)
+    static void injectDefines(std::string &shaderCode, const std::string &defines);
 };
 
 #endif /* shader_hpp */
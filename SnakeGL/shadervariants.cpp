@@ -0,0 +1,61 @@
+//
+//  shadervariants.cpp
+//  SnakeGL
+//
+//  Created by Keegan Bilodeau on 10/19/26.
+//  Copyright © 2026 Keegan Bilodeau. All rights reserved.
+//
+
+#include "shadervariants.hpp"
+#include "memory.hpp"
+
+ShaderFeatures meshFeatures(bool textured, bool instanced, bool lit)
+{
+    return (textured ? FEATURE_TEXTURED : FEATURE_NONE) | (instanced ? FEATURE_INSTANCED : FEATURE_NONE) | (lit ? FEATURE_LIT : FEATURE_NONE);
+}
+
+ShaderVariants::ShaderVariants(const char* vertexPath, const char* fragmentPath) : mVertexPath(vertexPath), mFragmentPath(fragmentPath)
+{
+}
+
+ShaderVariants::~ShaderVariants()
+{
+    for (Shader* variant : mCompiled)
+    {
+        MemoryRegistry::get().destroyGL(GL_OBJECT_PROGRAM, &variant->ID, 1);
+        glDeleteProgram(variant->ID);
+    }
+}
+
+Shader &ShaderVariants::get(ShaderFeatures features)
+{
+    // Bits past the known features would only alias other variants
+    features &= (1 << FEATURE_COUNT) - 1;
+    
+    std::unique_ptr<Shader> &variant = mVariants[features];
+    if (variant == nullptr)
+    {
+        variant.reset(new Shader(mVertexPath.c_str(), mFragmentPath.c_str(), defines(features)));
+        mCompiled.push_back(variant.get());
+        
+        if (!variant->linked)
+            printf("ERROR::SHADER::VARIANT_FAILED\n%s%s\n", mFragmentPath.c_str(), defines(features).c_str());
+    }
+    
+    return *variant;
+}
+
+const std::vector<Shader*> &ShaderVariants::getCompiled() const
+{
+    return mCompiled;
+}
+
+std::string ShaderVariants::defines(ShaderFeatures features)
+{
+    std::string block;
+    for (int bit = 0; bit < FEATURE_COUNT; bit++)
+        if (features & (1 << bit))
+            block += std::string("#define ") + FEATURE_DEFINES[bit] + "\n";
+    
+    return block;
+}
@@ -0,0 +1,63 @@
+//
+//  shadervariants.hpp
+//  SnakeGL
+//
+//  Created by Keegan Bilodeau on 10/19/26.
+//  Copyright © 2026 Keegan Bilodeau. All rights reserved.
+//
+
+#ifndef shadervariants_hpp
+#define shadervariants_hpp
+
+#include <stdio.h>
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "shader.hpp"
+
+// Features a shader variant is compiled with, combined into a bitmask
+typedef uint32_t ShaderFeatures;
+constexpr ShaderFeatures FEATURE_NONE = 0;
+constexpr ShaderFeatures FEATURE_TEXTURED = 1 << 0;
+constexpr ShaderFeatures FEATURE_INSTANCED = 1 << 1;
+constexpr ShaderFeatures FEATURE_LIT = 1 << 2;
+constexpr ShaderFeatures FEATURE_FOG = 1 << 3;
+constexpr int FEATURE_COUNT = 4;
+
+// Preprocessor symbol defined for each feature bit, in bit order
+constexpr const char* FEATURE_DEFINES[FEATURE_COUNT] = {"TEXTURED", "INSTANCED", "LIT", "FOG"};
+
+// Features a mesh is drawn with, from whether its VAO has texture coordinates and per instance model
+// matrices and whether it is lit, so no draw pays for a feature it does not use
+ShaderFeatures meshFeatures(bool textured, bool instanced, bool lit);
+
+// Every variant of one vertex and fragment shader pair
+// Features are #defines injected after the #version line, so each variant only contains the code it
+// needs instead of branching on uniforms. Variants are compiled the first time they are asked for
+class ShaderVariants
+{
+public:
+    ShaderVariants(const char* vertexPath, const char* fragmentPath);
+    ~ShaderVariants();
+    
+    // Returns the variant for a feature mask, compiling it if this is the first request
+    // Needs a current GL context, a variant that fails to link is kept and reported only once
+    Shader &get(ShaderFeatures features);
+    
+    // Variants compiled so far, in the order they were compiled
+    const std::vector<Shader*> &getCompiled() const;
+    
+    // The #define block injected for a feature mask
+    static std::string defines(ShaderFeatures features);
+
+private:
+    std::string mVertexPath, mFragmentPath;
+    
+    // One slot per possible mask, empty until the variant is first used
+    std::unique_ptr<Shader> mVariants[1 << FEATURE_COUNT];
+    std::vector<Shader*> mCompiled;
+};
+
+#endif /* shadervariants_hpp */
@@ -0,0 +1,350 @@
+//
+//  snakemesh.cpp
+//  SnakeGL
+//
+//  Created by Keegan Bilodeau on 10/19/26.
+//  Copyright © 2026 Keegan Bilodeau. All rights reserved.
+//
+
+#include "snakemesh.hpp"
+#include "memory.hpp"
+
+#include <math.h>
+#include <algorithm>
+
+#include <glad/glad.h>
+
+// Rebuilds with fewer pieces than this stay in one share, and every share gets at least half as many
+const size_t SNAKE_PARALLEL_PIECES = 128;
+
+SnakeMesher::SnakeMesher(float cellSize, const glm::vec3 &origin, float radius, const glm::vec3 &color) : piecesBuilt(0), mCellSize(cellSize), mRadius(radius * cellSize), mOrigin(origin), mBoardWidth(0), mChanged(false), mVAO(0), mVBO(0), mEBO(0), mIndexCount(0)
+{
+    for (int i = 0; i < 3; i++)
+        mColor[i] = (uint8_t) (std::min(std::max(color[i], 0.0f), 1.0f) * 255.0f + 0.5f);
+    mColor[3] = 255;
+}
+
+SnakeMesher::~SnakeMesher()
+{
+    MemoryRegistry &registry = MemoryRegistry::get();
+    registry.releaseCPU(this);
+    
+    if (mVAO == 0)
+        return;
+    
+    registry.destroyGL(GL_OBJECT_VERTEX_ARRAY, &mVAO, 1);
+    registry.destroyGL(GL_OBJECT_BUFFER, &mVBO, 1);
+    registry.destroyGL(GL_OBJECT_BUFFER, &mEBO, 1);
+    glDeleteVertexArrays(1, &mVAO);
+    glDeleteBuffers(1, &mVBO);
+    glDeleteBuffers(1, &mEBO);
+}
+
+void SnakeMesher::initGPU()
+{
+    glGenVertexArrays(1, &mVAO);
+    glGenBuffers(1, &mVBO);
+    glGenBuffers(1, &mEBO);
+    MemoryRegistry::get().createGL(GL_OBJECT_VERTEX_ARRAY, &mVAO, 1, MEMORY_GEOMETRY);
+    MemoryRegistry::get().createGL(GL_OBJECT_BUFFER, &mVBO, 1, MEMORY_GEOMETRY);
+    MemoryRegistry::get().createGL(GL_OBJECT_BUFFER, &mEBO, 1, MEMORY_GEOMETRY);
+    
+    glBindVertexArray(mVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, mVBO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mEBO);
+    
+    // Same locations as the generated shapes, the normal and color are unpacked by the vertex fetch
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(SnakeVertex), (void*) offsetof(SnakeVertex, position));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_BYTE, GL_TRUE, sizeof(SnakeVertex), (void*) offsetof(SnakeVertex, normal));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 3, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(SnakeVertex), (void*) offsetof(SnakeVertex, color));
+    glEnableVertexAttribArray(2);
+    
+    glBindVertexArray(0);
+}
+
+bool SnakeMesher::build(const Board &board, const glm::vec3 &cameraPos)
+{
+    if (!plan(board, cameraPos))
+        return false;
+    
+    buildPieces(0, 1);
+    pack();
+    
+    return true;
+}
+
+bool SnakeMesher::plan(const Board &board, const glm::vec3 &cameraPos)
+{
+    // A different board size invalidates every piece
+    int cellCount = board.getWidth() * board.getHeight();
+    if (board.getWidth() != mBoardWidth || (int) mPieces.size() != cellCount)
+    {
+        mBoardWidth = board.getWidth();
+        mPieces.assign(cellCount, TubePiece());
+        mPreviousLive.clear();
+    }
+    
+    // Walks every live snake from tail to head, body cells point towards the next segment
+    mLive.clear();
+    std::vector<int> snakeStarts;
+    for (int index = 0; index < board.getSnakeCount(); index++)
+    {
+        const Snake &snake = board.getSnake(index);
+        if (!snake.alive)
+            continue;
+        
+        snakeStarts.push_back((int) mLive.size());
+        for (int cell = snake.tail; cell >= 0; cell = board.getNeighbor(cell, (Direction) (board.getCell(cell) - CELL_BODY)))
+        {
+            mLive.push_back(cell);
+            if (cell == snake.head)
+                break;
+        }
+    }
+    snakeStarts.push_back((int) mLive.size());
+    
+    // Level of detail of every live cell, by distance from the camera
+    std::vector<int> lods(mLive.size());
+    for (size_t i = 0; i < mLive.size(); i++)
+    {
+        float distance = glm::length(cellCenter(mLive[i]) - cameraPos);
+        int lod = 0;
+        while (lod < SNAKE_LOD_COUNT - 1 && distance > SNAKE_LOD_DISTANCES[lod])
+            lod++;
+        lods[i] = lod;
+    }
+    
+    // A piece is rebuilt when its neighbors or the detail of it or its neighbors changed
+    mDirty.clear();
+    for (size_t snake = 0; snake + 1 < snakeStarts.size(); snake++)
+    {
+        int first = snakeStarts[snake], last = snakeStarts[snake + 1] - 1;
+        for (int i = first; i <= last; i++)
+        {
+            int sides = SNAKE_LOD_SIDES[lods[i]];
+            
+            // Shared rings use the coarser side count so that neighboring pieces meet without gaps
+            TubePiece wanted;
+            wanted.prev = i > first ? mLive[i - 1] : -1;
+            wanted.next = i < last ? mLive[i + 1] : -1;
+            wanted.lod = lods[i];
+            wanted.startSides = i > first ? std::min(sides, SNAKE_LOD_SIDES[lods[i - 1]]) : sides;
+            wanted.endSides = i < last ? std::min(sides, SNAKE_LOD_SIDES[lods[i + 1]]) : sides;
+            
+            TubePiece &piece = mPieces[mLive[i]];
+            if (piece.valid && piece.prev == wanted.prev && piece.next == wanted.next && piece.lod == wanted.lod && piece.startSides == wanted.startSides && piece.endSides == wanted.endSides)
+                continue;
+            
+            piece.prev = wanted.prev;
+            piece.next = wanted.next;
+            piece.lod = wanted.lod;
+            piece.startSides = wanted.startSides;
+            piece.endSides = wanted.endSides;
+            mDirty.push_back(mLive[i]);
+        }
+    }
+    
+    if (mDirty.empty() && mLive == mPreviousLive)
+        return false;
+    
+    piecesBuilt += mDirty.size();
+    
+    return true;
+}
+
+void SnakeMesher::buildPieces(unsigned int part, unsigned int parts)
+{
+    // Small rebuilds are not worth splitting, so only the first share gets any pieces
+    size_t shares = std::min((size_t) std::max(1u, parts), mDirty.size() / (SNAKE_PARALLEL_PIECES / 2));
+    if (mDirty.size() < SNAKE_PARALLEL_PIECES || shares < 2)
+        shares = 1;
+    if (part >= shares)
+        return;
+    
+    // Pieces only write their own geometry, so shares can be built on separate threads
+    size_t begin = mDirty.size() * part / shares, end = mDirty.size() * (part + 1) / shares;
+    for (size_t i = begin; i < end; i++)
+        buildPiece(mDirty[i], mPieces[mDirty[i]]);
+}
+
+void SnakeMesher::pack()
+{
+    // Packs every live piece into the streaming mesh, offsetting its indices
+    mVertices.clear();
+    mIndices.clear();
+    for (int cell : mLive)
+    {
+        const TubePiece &piece = mPieces[cell];
+        uint32_t base = (uint32_t) mVertices.size();
+        mVertices.insert(mVertices.end(), piece.vertices.begin(), piece.vertices.end());
+        for (uint32_t index : piece.indices)
+            mIndices.push_back(base + index);
+    }
+    
+    // Pieces of cells the snakes have left keep their memory until they are reused, only live ones are counted
+    size_t bytes = mPieces.capacity() * sizeof(TubePiece) + mVertices.capacity() * sizeof(SnakeVertex) + mIndices.capacity() * sizeof(uint32_t);
+    for (int cell : mLive)
+        bytes += mPieces[cell].vertices.capacity() * sizeof(SnakeVertex) + mPieces[cell].indices.capacity() * sizeof(uint32_t);
+    MemoryRegistry::get().setCPU(this, MEMORY_GEOMETRY, bytes);
+    
+    mPreviousLive.swap(mLive);
+    mChanged = true;
+}
+
+void SnakeMesher::upload(GLStateCache &cache)
+{
+    if (!mChanged || mVAO == 0)
+        return;
+    
+    // Orphans the old storage so the upload does not wait on draws still using it
+    glBindBuffer(GL_ARRAY_BUFFER, mVBO);
+    glBufferData(GL_ARRAY_BUFFER, mVertices.size() * sizeof(SnakeVertex), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, mVertices.size() * sizeof(SnakeVertex), mVertices.data());
+    MemoryRegistry::get().resizeGL(GL_OBJECT_BUFFER, mVBO, mVertices.size() * sizeof(SnakeVertex));
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    
+    // The element buffer is part of the vertex array's state, so it is bound through it
+    cache.bindVertexArray(mVAO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, mIndices.size() * sizeof(uint32_t), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, mIndices.size() * sizeof(uint32_t), mIndices.data());
+    MemoryRegistry::get().resizeGL(GL_OBJECT_BUFFER, mEBO, mIndices.size() * sizeof(uint32_t));
+    
+    mIndexCount = (unsigned int) mIndices.size();
+    mChanged = false;
+}
+
+unsigned int SnakeMesher::getVAO() const
+{
+    return mVAO;
+}
+
+unsigned int SnakeMesher::getIndexCount() const
+{
+    return mIndexCount;
+}
+
+const std::vector<SnakeVertex> &SnakeMesher::getVertices() const
+{
+    return mVertices;
+}
+
+const std::vector<uint32_t> &SnakeMesher::getIndices() const
+{
+    return mIndices;
+}
+
+
+void SnakeMesher::buildPiece(int cell, TubePiece &piece) const
+{
+    piece.vertices.clear();
+    piece.indices.clear();
+    piece.valid = true;
+    
+    // The piece runs from entry to exit, bending around the cell when the two directions differ
+    glm::vec3 center = cellCenter(cell);
+    glm::vec3 entry, exit;
+    if (piece.prev >= 0)
+        entry = (cellCenter(piece.prev) + center) * 0.5f;
+    if (piece.next >= 0)
+        exit = (center + cellCenter(piece.next)) * 0.5f;
+    
+    // The tail tapers in from the far edge of its cell and the head ends at its center, inside the head cube
+    if (piece.prev < 0)
+        entry = piece.next >= 0 ? center * 2.0f - exit : center;
+    if (piece.next < 0)
+        exit = center;
+    
+    glm::vec3 inDirection = center - entry, outDirection = exit - center;
+    bool corner = piece.prev >= 0 && piece.next >= 0 && glm::length(glm::cross(inDirection, outDirection)) > 1e-6f;
+    int steps = corner ? SNAKE_LOD_CORNER_STEPS[piece.lod] : 1;
+    int sides = SNAKE_LOD_SIDES[piece.lod];
+    
+    std::vector<uint32_t> rings(steps + 1);
+    std::vector<int> ringSides(steps + 1);
+    for (int step = 0; step <= steps; step++)
+    {
+        float t = (float) step / steps;
+        glm::vec3 point, tangent;
+        if (corner)
+        {
+            // Quarter circle around the cell corner inside the turn, its radius of half a cell stays
+            // larger than the tube's so the inside of the bend never folds over
+            float angle = 1.57079633f * t;
+            glm::vec3 pivot = entry + outDirection;
+            point = pivot - outDirection * cosf(angle) + inDirection * sinf(angle);
+            tangent = outDirection * sinf(angle) + inDirection * cosf(angle);
+        }
+        else
+        {
+            point = entry + (exit - entry) * t;
+            tangent = exit - entry;
+        }
+        
+        // A head on its own (a one cell snake) has no direction, any tangent in the board's plane will do
+        if (glm::length(tangent) < 1e-6f)
+            tangent = glm::vec3(1.0f, 0.0f, 0.0f);
+        
+        float radius = piece.prev < 0 ? mRadius * t : mRadius;
+        ringSides[step] = step == 0 ? piece.startSides : (step == steps ? piece.endSides : sides);
+        rings[step] = (uint32_t) piece.vertices.size();
+        addRing(piece, point, glm::normalize(tangent), radius, ringSides[step]);
+    }
+    
+    for (int step = 0; step < steps; step++)
+        stitch(piece, rings[step], ringSides[step], rings[step + 1], ringSides[step + 1]);
+}
+
+void SnakeMesher::addRing(TubePiece &piece, const glm::vec3 &center, const glm::vec3 &tangent, float radius, int sides) const
+{
+    // Tangents always lie in the board's plane, so the frame never twists and rings of neighboring
+    // pieces line up vertex for vertex
+    glm::vec3 up(0.0f, 0.0f, 1.0f);
+    glm::vec3 side = glm::cross(tangent, up);
+    
+    for (int i = 0; i < sides; i++)
+    {
+        float angle = 6.28318531f * i / sides;
+        glm::vec3 normal = side * cosf(angle) + up * sinf(angle);
+        glm::vec3 position = center + normal * radius;
+        
+        SnakeVertex vertex;
+        for (int axis = 0; axis < 3; axis++)
+        {
+            vertex.position[axis] = position[axis];
+            vertex.normal[axis] = (int8_t) lroundf(normal[axis] * 127.0f);
+            vertex.color[axis] = mColor[axis];
+        }
+        vertex.normal[3] = 0;
+        vertex.color[3] = mColor[3];
+        
+        piece.vertices.push_back(vertex);
+    }
+}
+
+void SnakeMesher::stitch(TubePiece &piece, uint32_t ringA, int sidesA, uint32_t ringB, int sidesB)
+{
+    // Walks around both rings at once, always advancing the one whose next vertex comes first, so
+    // every step adds one counter clockwise triangle
+    int a = 0, b = 0;
+    while (a < sidesA || b < sidesB)
+    {
+        uint32_t currentA = ringA + a % sidesA, currentB = ringB + b % sidesB;
+        if (b >= sidesB || (a < sidesA && (a + 1) * sidesB <= (b + 1) * sidesA))
+        {
+            a++;
+            piece.indices.insert(piece.indices.end(), {currentA, currentB, ringA + a % sidesA});
+        }
+        else
+        {
+            b++;
+            piece.indices.insert(piece.indices.end(), {currentA, currentB, ringB + b % sidesB});
+        }
+    }
+}
+
+glm::vec3 SnakeMesher::cellCenter(int cell) const
+{
+    return mOrigin + glm::vec3((cell % mBoardWidth + 0.5f) * mCellSize, (cell / mBoardWidth + 0.5f) * mCellSize, 0.0f);
+}
@@ -0,0 +1,120 @@
+//
+//  snakemesh.hpp
+//  SnakeGL
+//
+//  Created by Keegan Bilodeau on 10/19/26.
+//  Copyright © 2026 Keegan Bilodeau. All rights reserved.
+//
+
+#ifndef snakemesh_hpp
+#define snakemesh_hpp
+
+#include <stdio.h>
+#include <stdint.h>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "board.hpp"
+#include "renderqueue.hpp"
+
+// Level of detail a body piece is built at, picked from its distance to the camera
+const int SNAKE_LOD_COUNT = 3;
+const float SNAKE_LOD_DISTANCES[SNAKE_LOD_COUNT - 1] = {1.5f, 3.0f};
+
+// Vertices around the tube and steps along a turning piece for every level of detail
+const int SNAKE_LOD_SIDES[SNAKE_LOD_COUNT] = {16, 8, 4};
+const int SNAKE_LOD_CORNER_STEPS[SNAKE_LOD_COUNT] = {6, 3, 1};
+
+// Packed tube vertex: position, signed normalized normal and normalized color (20 bytes)
+struct SnakeVertex
+{
+    float position[3];
+    int8_t normal[4];
+    uint8_t color[4];
+};
+
+// Builds smooth tubes along every live snake's body into one streaming vertex buffer
+// Every body cell owns one piece of the tube, which runs from the middle of the edge shared with the
+// previous segment to the middle of the edge shared with the next one, and follows a quarter circle
+// when the snake turns there. A piece only depends on its neighbors and level of detail, so
+// between ticks just the pieces at the head and tail are rebuilt, and long rebuilds can be split
+// into shares that run as separate jobs
+class SnakeMesher
+{
+public:
+    // origin is the world position of the board's bottom left corner, radius is relative to the cell size and has to stay below half a cell
+    SnakeMesher(float cellSize, const glm::vec3 &origin, float radius = 0.4f, const glm::vec3 &color = glm::vec3(0.2f, 0.8f, 0.3f));
+    ~SnakeMesher();
+    
+    // Creates the streaming vertex array, needs a current GL context
+    // Changes the bound vertex array, so a GLStateCache must be invalidated afterwards
+    void initGPU();
+    
+    // Rebuilds the pieces that changed since the last build and repacks the mesh, no GL calls
+    // Returns true if the mesh changed
+    bool build(const Board &board, const glm::vec3 &cameraPos);
+    
+    // The steps of build, for running the rebuild across jobs
+    // plan finds the pieces that changed and returns false if the mesh stays as it is, only then
+    // every share of buildPieces has to run (in any order or at once) before pack repacks the mesh
+    bool plan(const Board &board, const glm::vec3 &cameraPos);
+    void buildPieces(unsigned int part, unsigned int parts);
+    void pack();
+    
+    // Uploads the mesh if it changed since the last upload, binding the vertex array through the cache
+    void upload(GLStateCache &cache);
+    
+    // Vertex array and index count to draw the tubes with, indices are 32 bit
+    unsigned int getVAO() const;
+    unsigned int getIndexCount() const;
+    
+    // Packed mesh of the last build
+    const std::vector<SnakeVertex> &getVertices() const;
+    const std::vector<uint32_t> &getIndices() const;
+    
+    // Pieces rebuilt over the mesher's lifetime
+    uint64_t piecesBuilt;
+
+private:
+    // One cell's part of the tube and the inputs it was built from
+    struct TubePiece
+    {
+        int prev = -1, next = -1, lod = 0, startSides = 0, endSides = 0;
+        bool valid = false;
+        
+        std::vector<SnakeVertex> vertices;
+        std::vector<uint32_t> indices;
+    };
+    
+    // Builds the geometry of the piece in a cell from its stored inputs
+    void buildPiece(int cell, TubePiece &piece) const;
+    
+    // Adds a ring of vertices around center, facing along tangent
+    void addRing(TubePiece &piece, const glm::vec3 &center, const glm::vec3 &tangent, float radius, int sides) const;
+    
+    // Connects two rings with different vertex counts into a band of triangles
+    static void stitch(TubePiece &piece, uint32_t ringA, int sidesA, uint32_t ringB, int sidesB);
+    
+    // World position of a cell's center
+    glm::vec3 cellCenter(int cell) const;
+    
+    float mCellSize, mRadius;
+    glm::vec3 mOrigin;
+    uint8_t mColor[4];
+    int mBoardWidth;
+    
+    // Pieces indexed by cell, the cells of this build from tail to head, and the cells that need rebuilding
+    std::vector<TubePiece> mPieces;
+    std::vector<int> mLive, mPreviousLive, mDirty;
+    
+    // Packed mesh, and whether it changed since it was last uploaded
+    std::vector<SnakeVertex> mVertices;
+    std::vector<uint32_t> mIndices;
+    bool mChanged;
+    
+    unsigned int mVAO, mVBO, mEBO;
+    unsigned int mIndexCount;
+};
+
+#endif /* snakemesh_hpp */
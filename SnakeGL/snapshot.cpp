@@ -0,0 +1,169 @@
+//
+//  snapshot.cpp
+//  SnakeGL
+//
+//  Created by Keegan Bilodeau on 10/19/26.
+//  Copyright © 2026 Keegan Bilodeau. All rights reserved.
+//
+
+#include "snapshot.hpp"
+
+#include <string.h>
+#include <type_traits>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static_assert(std::is_trivially_copyable<GameState>::value, "GameState must be trivially copyable");
+
+// Identifies checkpoint files
+static const char CHECKPOINT_MAGIC[4] = {'S', 'N', 'K', 'C'};
+
+// Rounds an offset up to the record alignment
+static uint64_t alignRecord(uint64_t offset)
+{
+    return (offset + CHECKPOINT_ALIGNMENT - 1) & ~(uint64_t) (CHECKPOINT_ALIGNMENT - 1);
+}
+
+CheckpointFile::CheckpointFile() : mData(nullptr), mSize(0), mEntries(nullptr), mCount(0)
+{
+}
+
+CheckpointFile::~CheckpointFile()
+{
+    close();
+}
+
+bool CheckpointFile::save(const char* path, const std::vector<GameState> &games, const std::vector<const Board*> &boards)
+{
+    if (games.size() != boards.size())
+        return false;
+    
+    CheckpointHeader header = {};
+    memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+    header.version = CHECKPOINT_VERSION;
+    header.boardVersion = BOARD_STATE_VERSION;
+    header.count = (uint32_t) games.size();
+    header.gameSize = sizeof(GameState);
+    
+    // Lays every record out after the entry table, each part on its own aligned offset
+    std::vector<CheckpointEntry> entries(games.size());
+    uint64_t offset = alignRecord(sizeof(CheckpointHeader) + entries.size() * sizeof(CheckpointEntry));
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        entries[i].gameOffset = offset;
+        entries[i].boardOffset = alignRecord(offset + sizeof(GameState));
+        entries[i].boardSize = boards[i]->getStateSize();
+        offset = alignRecord(entries[i].boardOffset + entries[i].boardSize);
+    }
+    
+    FILE* file = fopen(path, "wb");
+    if (file == nullptr)
+    {
+        printf("ERROR::CHECKPOINT::FILE_NOT_WRITTEN\n%s\n", path);
+        return false;
+    }
+    
+    // Padding between records is written as zeros
+    static const uint8_t padding[CHECKPOINT_ALIGNMENT] = {};
+    uint64_t written = 0;
+    auto write = [&](const void* data, uint64_t size, uint64_t at) -> bool
+    {
+        bool ok = fwrite(padding, 1, at - written, file) == at - written && fwrite(data, 1, size, file) == size;
+        written = at + size;
+        return ok;
+    };
+    
+    bool ok = write(&header, sizeof(header), 0) && write(entries.data(), entries.size() * sizeof(CheckpointEntry), sizeof(header));
+    for (size_t i = 0; i < entries.size() && ok; i++)
+        ok = write(&games[i], sizeof(GameState), entries[i].gameOffset) && write(boards[i]->getState(), entries[i].boardSize, entries[i].boardOffset);
+    
+    ok = fclose(file) == 0 && ok;
+    if (!ok)
+        printf("ERROR::CHECKPOINT::FILE_NOT_WRITTEN\n%s\n", path);
+    
+    return ok;
+}
+
+bool CheckpointFile::open(const char* path)
+{
+    close();
+    
+    int file = ::open(path, O_RDONLY);
+    if (file < 0)
+    {
+        printf("ERROR::CHECKPOINT::FILE_NOT_READ\n%s\n", path);
+        return false;
+    }
+    
+    struct stat info;
+    void* data = MAP_FAILED;
+    if (fstat(file, &info) == 0 && info.st_size >= (off_t) sizeof(CheckpointHeader))
+        data = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    
+    // The mapping stays valid after the descriptor is closed
+    ::close(file);
+    if (data == MAP_FAILED)
+    {
+        printf("ERROR::CHECKPOINT::FILE_NOT_READ\n%s\n", path);
+        return false;
+    }
+    
+    mData = (const uint8_t*) data;
+    mSize = info.st_size;
+    
+    // Rejects files from other versions or builds with a different GameState
+    const CheckpointHeader* header = (const CheckpointHeader*) mData;
+    bool valid = memcmp(header->magic, CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC)) == 0 && header->version == CHECKPOINT_VERSION && header->boardVersion == BOARD_STATE_VERSION && header->gameSize == sizeof(GameState);
+    valid = valid && sizeof(CheckpointHeader) + (uint64_t) header->count * sizeof(CheckpointEntry) <= mSize;
+    
+    // Every record has to lie inside the file
+    const CheckpointEntry* entries = (const CheckpointEntry*) (mData + sizeof(CheckpointHeader));
+    for (uint32_t i = 0; valid && i < header->count; i++)
+    {
+        const CheckpointEntry &entry = entries[i];
+        valid = entry.gameOffset % CHECKPOINT_ALIGNMENT == 0 && entry.boardOffset % CHECKPOINT_ALIGNMENT == 0;
+        valid = valid && entry.gameOffset + sizeof(GameState) <= mSize && entry.boardSize <= mSize && entry.boardOffset <= mSize - entry.boardSize;
+    }
+    
+    if (!valid)
+    {
+        printf("ERROR::CHECKPOINT::INVALID_FILE\n%s\n", path);
+        close();
+        return false;
+    }
+    
+    mEntries = entries;
+    mCount = header->count;
+    
+    return true;
+}
+
+void CheckpointFile::close()
+{
+    if (mData != nullptr)
+        munmap((void*) mData, mSize);
+    
+    mData = nullptr;
+    mSize = 0;
+    mEntries = nullptr;
+    mCount = 0;
+}
+
+size_t CheckpointFile::getCount() const
+{
+    return mCount;
+}
+
+const GameState &CheckpointFile::getGame(size_t record) const
+{
+    return *(const GameState*) (mData + mEntries[record].gameOffset);
+}
+
+bool CheckpointFile::loadBoard(size_t record, Board &board) const
+{
+    const CheckpointEntry &entry = mEntries[record];
+    
+    return board.loadState(mData + entry.boardOffset, entry.boardSize);
+}
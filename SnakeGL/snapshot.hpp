@@ -0,0 +1,88 @@
+//
+//  snapshot.hpp
+//  SnakeGL
+//
+//  Created by Keegan Bilodeau on 10/19/26.
+//  Copyright © 2026 Keegan Bilodeau. All rights reserved.
+//
+
+#ifndef snapshot_hpp
+#define snapshot_hpp
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "board.hpp"
+#include "camera.hpp"
+
+// Bumped whenever the checkpoint file layout or GameState changes
+const uint32_t CHECKPOINT_VERSION = 2;
+
+// Records in a checkpoint file start on this boundary so they can be used straight from the mapping
+const size_t CHECKPOINT_ALIGNMENT = 64;
+
+// Everything outside the board that makes up a running game, kept flat so it can be copied with memcpy
+struct GameState
+{
+    CameraState camera;
+    
+    // Frame timing and the time collected towards the next game tick
+    float deltaTime, lastFrame, tickTimer;
+    
+    // The player's snake and whether the autopilot is steering it
+    int player;
+    bool autopilot;
+};
+
+// Start of a checkpoint file, followed by one CheckpointEntry per record
+struct CheckpointHeader
+{
+    char magic[4];
+    uint32_t version, boardVersion, count;
+    uint64_t gameSize;
+};
+
+// Where one record's game state and board state live in the file
+struct CheckpointEntry
+{
+    uint64_t gameOffset, boardOffset, boardSize;
+};
+
+// Versioned binary file holding any number of game and board states
+// Files are memory mapped when opened, so loading a board is a single copy out of the mapping
+class CheckpointFile
+{
+public:
+    CheckpointFile();
+    ~CheckpointFile();
+    
+    // Writes one record per game and board pair, returns false if the file could not be written
+    static bool save(const char* path, const std::vector<GameState> &games, const std::vector<const Board*> &boards);
+    
+    // Maps a checkpoint file, returns false if it is missing or not a valid checkpoint of this version
+    bool open(const char* path);
+    
+    // Unmaps the file, also done by the destructor
+    void close();
+    
+    // Number of records in the open file
+    size_t getCount() const;
+    
+    // Game state of a record, points into the mapping so it is only valid while the file is open
+    const GameState &getGame(size_t record) const;
+    
+    // Replaces a board with a record's board state, returns false if the state is not valid
+    bool loadBoard(size_t record, Board &board) const;
+
+private:
+    const uint8_t* mData;
+    size_t mSize;
+    const CheckpointEntry* mEntries;
+    size_t mCount;
+};
+
+#endif /* snapshot_hpp */
@@ -0,0 +1,329 @@
+//
+//  text.cpp
+//  SnakeGL
+//
+//  Created by Keegan Bilodeau on 10/19/26.
+//  Copyright © 2026 Keegan Bilodeau. All rights reserved.
+//
+
+#define STB_TRUETYPE_IMPLEMENTATION
+
+#include "text.hpp"
+#include "memory.hpp"
+
+#include <math.h>
+#include <string.h>
+#include <fstream>
+#include <iterator>
+
+#include <stb_truetype.h>
+#include <glm/gtc/matrix_transform.hpp>
+
+// Glyph quads are drawn as two triangles over four vertices
+const unsigned int GLYPH_VERTEX_COUNT = 4, GLYPH_INDEX_COUNT = 6;
+
+TextRenderer::TextRenderer() : glyphsBuilt(0), drawCalls(0), mDirty(true), mGlyphs(), mAscent(0.0f), mLineHeight(0.0f), mAtlas(0), mVAO(0), mVBO(0), mEBO(0), mIndexedGlyphs(0), mUploadedGlyphs(0)
+{
+}
+
+TextRenderer::~TextRenderer()
+{
+    MemoryRegistry &registry = MemoryRegistry::get();
+    registry.releaseCPU(this);
+    
+    // Nothing was created if the font never loaded
+    if (mAtlas == 0)
+        return;
+    
+    registry.destroyGL(GL_OBJECT_TEXTURE, &mAtlas, 1);
+    registry.destroyGL(GL_OBJECT_VERTEX_ARRAY, &mVAO, 1);
+    registry.destroyGL(GL_OBJECT_BUFFER, &mVBO, 1);
+    registry.destroyGL(GL_OBJECT_BUFFER, &mEBO, 1);
+    registry.destroyGL(GL_OBJECT_PROGRAM, &mShader->ID, 1);
+    glDeleteTextures(1, &mAtlas);
+    glDeleteVertexArrays(1, &mVAO);
+    glDeleteBuffers(1, &mVBO);
+    glDeleteBuffers(1, &mEBO);
+    glDeleteProgram(mShader->ID);
+}
+
+bool TextRenderer::loadFont(const char* fontPath, float pixelHeight, int atlasSize)
+{
+    // Reads the whole font file, stb_truetype works on the raw bytes
+    std::ifstream fontFile(fontPath, std::ios::binary);
+    std::vector<unsigned char> font((std::istreambuf_iterator<char>(fontFile)), std::istreambuf_iterator<char>());
+    if (font.empty())
+    {
+        printf("ERROR::TEXT::FONT_NOT_SUCCESSFULLY_READ\n%s\n", fontPath);
+        return false;
+    }
+    
+    // Bakes every printable character into a single channel bitmap
+    std::vector<unsigned char> bitmap((size_t) atlasSize * atlasSize);
+    stbtt_bakedchar baked[TEXT_CHAR_COUNT];
+    if (stbtt_BakeFontBitmap(font.data(), 0, pixelHeight, bitmap.data(), atlasSize, atlasSize, TEXT_FIRST_CHAR, TEXT_CHAR_COUNT, baked) <= 0)
+    {
+        printf("ERROR::TEXT::ATLAS_TOO_SMALL\n%s at %.0f pixels does not fit in %d pixels\n", fontPath, pixelHeight, atlasSize);
+        return false;
+    }
+    
+    // Vertical metrics place the first baseline so that (x, y) is the top left of the text
+    stbtt_fontinfo info;
+    stbtt_InitFont(&info, font.data(), stbtt_GetFontOffsetForIndex(font.data(), 0));
+    int ascent, descent, lineGap;
+    stbtt_GetFontVMetrics(&info, &ascent, &descent, &lineGap);
+    float scale = stbtt_ScaleForPixelHeight(&info, pixelHeight);
+    mAscent = ascent * scale;
+    mLineHeight = (ascent - descent + lineGap) * scale;
+    
+    // Keeps only what building quads needs from the baked characters
+    for (int i = 0; i < TEXT_CHAR_COUNT; i++)
+    {
+        const stbtt_bakedchar &character = baked[i];
+        Glyph &glyph = mGlyphs[i];
+        glyph.offsetX = character.xoff;
+        glyph.offsetY = character.yoff;
+        glyph.width = character.x1 - character.x0;
+        glyph.height = character.y1 - character.y0;
+        glyph.advance = character.xadvance;
+        glyph.s0 = (float) character.x0 / atlasSize;
+        glyph.t0 = (float) character.y0 / atlasSize;
+        glyph.s1 = (float) character.x1 / atlasSize;
+        glyph.t1 = (float) character.y1 / atlasSize;
+    }
+    
+    // The atlas only stores coverage, rows are tightly packed single bytes
+    glGenTextures(1, &mAtlas);
+    glBindTexture(GL_TEXTURE_2D, mAtlas);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, atlasSize, atlasSize, 0, GL_RED, GL_UNSIGNED_BYTE, bitmap.data());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    MemoryRegistry::get().createGL(GL_OBJECT_TEXTURE, &mAtlas, 1, MEMORY_TEXT);
+    MemoryRegistry::get().resizeGL(GL_OBJECT_TEXTURE, mAtlas, MemoryRegistry::textureBytes(atlasSize, atlasSize, 1));
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    
+    // One vertex buffer for all text, refilled whenever any text changes
+    glGenVertexArrays(1, &mVAO);
+    glBindVertexArray(mVAO);
+    MemoryRegistry::get().createGL(GL_OBJECT_VERTEX_ARRAY, &mVAO, 1, MEMORY_TEXT);
+    
+    glGenBuffers(1, &mVBO);
+    MemoryRegistry::get().createGL(GL_OBJECT_BUFFER, &mVBO, 1, MEMORY_TEXT);
+    glBindBuffer(GL_ARRAY_BUFFER, mVBO);
+    
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(TextVertex), (void*) offsetof(TextVertex, position));
+    glEnableVertexAttribArray(0);
+    
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(TextVertex), (void*) offsetof(TextVertex, texCoord));
+    glEnableVertexAttribArray(1);
+    
+    glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(TextVertex), (void*) offsetof(TextVertex, color));
+    glEnableVertexAttribArray(2);
+    
+    // The index buffer is bound to the vertex array and only grows
+    glGenBuffers(1, &mEBO);
+    MemoryRegistry::get().createGL(GL_OBJECT_BUFFER, &mEBO, 1, MEMORY_TEXT);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mEBO);
+    reserveGlyphs(256);
+    
+    glBindVertexArray(0);
+    
+    mShader.reset(new Shader("resources/textShader.vert", "resources/textShader.frag"));
+    mDirty = true;
+    
+    return true;
+}
+
+int TextRenderer::createText()
+{
+    mTexts.push_back(TextEntry{std::string(), 0.0f, 0.0f, glm::vec3(1.0f), true, std::vector<TextVertex>()});
+    
+    return (int) mTexts.size() - 1;
+}
+
+void TextRenderer::setText(int id, const std::string &text, float x, float y, const glm::vec3 &color)
+{
+    TextEntry &entry = mTexts[id];
+    
+    // Unchanged text keeps its quads and leaves the vertex buffer alone
+    if (entry.text == text && entry.x == x && entry.y == y && entry.color == color)
+        return;
+    
+    entry.text = text;
+    entry.x = x;
+    entry.y = y;
+    entry.color = color;
+    buildText(entry);
+    
+    if (entry.visible)
+        mDirty = true;
+}
+
+void TextRenderer::setVisible(int id, bool visible)
+{
+    if (mTexts[id].visible == visible)
+        return;
+    
+    mTexts[id].visible = visible;
+    mDirty = true;
+}
+
+float TextRenderer::measure(const std::string &text) const
+{
+    float width = 0.0f, lineWidth = 0.0f;
+    
+    for (char character : text)
+    {
+        if (character == '\n')
+        {
+            lineWidth = 0.0f;
+            continue;
+        }
+        
+        int index = character - TEXT_FIRST_CHAR;
+        if (index >= 0 && index < TEXT_CHAR_COUNT)
+            lineWidth += mGlyphs[index].advance;
+        width = fmaxf(width, lineWidth);
+    }
+    
+    return width;
+}
+
+float TextRenderer::getLineHeight() const
+{
+    return mLineHeight;
+}
+
+void TextRenderer::render(GLStateCache &cache, float screenWidth, float screenHeight)
+{
+    if (mAtlas == 0)
+        return;
+    
+    // Refills the shared buffer from the cached quads only when some text changed
+    if (mDirty)
+    {
+        mVertices.clear();
+        for (const TextEntry &entry : mTexts)
+            if (entry.visible)
+                mVertices.insert(mVertices.end(), entry.vertices.begin(), entry.vertices.end());
+        
+        mUploadedGlyphs = mVertices.size() / GLYPH_VERTEX_COUNT;
+        
+        cache.bindVertexArray(mVAO);
+        reserveGlyphs(mUploadedGlyphs);
+        
+        // Orphans the old storage so the upload never waits on a draw still using it
+        glBindBuffer(GL_ARRAY_BUFFER, mVBO);
+        glBufferData(GL_ARRAY_BUFFER, mVertices.size() * sizeof(TextVertex), nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, mVertices.size() * sizeof(TextVertex), mVertices.data());
+        MemoryRegistry::get().resizeGL(GL_OBJECT_BUFFER, mVBO, mVertices.size() * sizeof(TextVertex));
+        
+        // Every text keeps its own vertices next to the packed copy
+        size_t bytes = mTexts.capacity() * sizeof(TextEntry) + mVertices.capacity() * sizeof(TextVertex);
+        for (const TextEntry &entry : mTexts)
+            bytes += entry.vertices.capacity() * sizeof(TextVertex);
+        MemoryRegistry::get().setCPU(this, MEMORY_TEXT, bytes);
+        
+        mDirty = false;
+    }
+    
+    if (mUploadedGlyphs == 0)
+        return;
+    
+    // Text is drawn over everything and blended by the glyph coverage
+    bool depthTest = glIsEnabled(GL_DEPTH_TEST), blend = glIsEnabled(GL_BLEND);
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    
+    // Pixel coordinates with the origin at the top left of the screen
+    cache.useProgram(mShader->ID);
+    cache.setUniform("projection", glm::ortho(0.0f, screenWidth, screenHeight, 0.0f));
+    cache.setUniform("glyphAtlas", 0);
+    cache.bindTexture(0, mAtlas);
+    cache.bindVertexArray(mVAO);
+    
+    glDrawElements(GL_TRIANGLES, (GLsizei) (mUploadedGlyphs * GLYPH_INDEX_COUNT), GL_UNSIGNED_INT, (void*) 0);
+    drawCalls++;
+    
+    if (depthTest)
+        glEnable(GL_DEPTH_TEST);
+    if (!blend)
+        glDisable(GL_BLEND);
+}
+
+void TextRenderer::buildText(TextEntry &entry)
+{
+    entry.vertices.clear();
+    
+    // Colors are stored as normalized bytes to keep the vertices small
+    uint8_t color[4] = {0, 0, 0, 255};
+    for (int i = 0; i < 3; i++)
+        color[i] = (uint8_t) (fminf(fmaxf(entry.color[i], 0.0f), 1.0f) * 255.0f + 0.5f);
+    
+    // The pen starts on the first baseline and moves along it one advance per character
+    float penX = entry.x, penY = entry.y + mAscent;
+    for (char character : entry.text)
+    {
+        if (character == '\n')
+        {
+            penX = entry.x;
+            penY += mLineHeight;
+            continue;
+        }
+        
+        int index = character - TEXT_FIRST_CHAR;
+        if (index < 0 || index >= TEXT_CHAR_COUNT)
+            continue;
+        
+        const Glyph &glyph = mGlyphs[index];
+        
+        // Snaps quads to whole pixels so the glyphs stay sharp, spaces have no quad at all
+        if (glyph.width > 0.0f && glyph.height > 0.0f)
+        {
+            float x0 = floorf(penX + glyph.offsetX + 0.5f), y0 = floorf(penY + glyph.offsetY + 0.5f);
+            float x1 = x0 + glyph.width, y1 = y0 + glyph.height;
+            
+            entry.vertices.push_back(TextVertex{{x0, y0}, {glyph.s0, glyph.t0}, {color[0], color[1], color[2], color[3]}});
+            entry.vertices.push_back(TextVertex{{x1, y0}, {glyph.s1, glyph.t0}, {color[0], color[1], color[2], color[3]}});
+            entry.vertices.push_back(TextVertex{{x1, y1}, {glyph.s1, glyph.t1}, {color[0], color[1], color[2], color[3]}});
+            entry.vertices.push_back(TextVertex{{x0, y1}, {glyph.s0, glyph.t1}, {color[0], color[1], color[2], color[3]}});
+            glyphsBuilt++;
+        }
+        
+        penX += glyph.advance;
+    }
+}
+
+void TextRenderer::reserveGlyphs(size_t glyphs)
+{
+    if (glyphs <= mIndexedGlyphs)
+        return;
+    
+    // Grows by doubling so that longer text rarely needs a new index buffer
+    size_t capacity = mIndexedGlyphs > 0 ? mIndexedGlyphs : 256;
+    while (capacity < glyphs)
+        capacity *= 2;
+    
+    // Every glyph uses the same two triangles over its four vertices
+    std::vector<unsigned int> indices(capacity * GLYPH_INDEX_COUNT);
+    for (size_t glyph = 0; glyph < capacity; glyph++)
+    {
+        unsigned int first = (unsigned int) (glyph * GLYPH_VERTEX_COUNT);
+        unsigned int* quad = &indices[glyph * GLYPH_INDEX_COUNT];
+        quad[0] = first;
+        quad[1] = first + 1;
+        quad[2] = first + 2;
+        quad[3] = first;
+        quad[4] = first + 2;
+        quad[5] = first + 3;
+    }
+    
+    // The element buffer binding belongs to the vertex array, which is bound by the caller
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+    MemoryRegistry::get().resizeGL(GL_OBJECT_BUFFER, mEBO, indices.size() * sizeof(unsigned int));
+    mIndexedGlyphs = capacity;
+}
@@ -0,0 +1,113 @@
+//
+//  text.hpp
+//  SnakeGL
+//
+//  Created by Keegan Bilodeau on 10/19/26.
+//  Copyright © 2026 Keegan Bilodeau. All rights reserved.
+//
+
+#ifndef text_hpp
+#define text_hpp
+
+#include <stdio.h>
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "renderqueue.hpp"
+#include "shader.hpp"
+
+// First character and number of characters baked into the glyph atlas (printable ASCII)
+const int TEXT_FIRST_CHAR = 32, TEXT_CHAR_COUNT = 95;
+
+// One corner of a glyph quad: position in pixels, atlas coordinates and a normalized RGBA8 color
+struct TextVertex
+{
+    float position[2];
+    float texCoord[2];
+    uint8_t color[4];
+};
+
+// Draws screen space text from a baked glyph atlas
+// Every piece of text keeps its glyph quads until its string, position or color changes, and all
+// visible text shares one streaming vertex buffer that is drawn with a single call
+class TextRenderer
+{
+public:
+    TextRenderer();
+    ~TextRenderer();
+    
+    // Bakes a TrueType font at the given pixel height into the atlas and creates the GL objects
+    // Needs a current GL context, returns false if the font could not be loaded or does not fit
+    // Changes the bound vertex array and texture, so a GLStateCache must be invalidated afterwards
+    bool loadFont(const char* fontPath, float pixelHeight = 20.0f, int atlasSize = 512);
+    
+    // Creates an empty piece of text and returns its id
+    int createText();
+    
+    // Changes a piece of text, (x, y) is its top left corner in pixels from the top left of the screen
+    // Its quads are only rebuilt when something actually changed
+    void setText(int id, const std::string &text, float x, float y, const glm::vec3 &color = glm::vec3(1.0f));
+    
+    // Hides or shows a piece of text without dropping its quads
+    void setVisible(int id, bool visible);
+    
+    // Width in pixels that a string takes up
+    float measure(const std::string &text) const;
+    
+    // Height in pixels of one line of text
+    float getLineHeight() const;
+    
+    // Uploads the text that changed since the last call and draws all visible text in one call
+    // Depth testing is turned off and blending on for the draw, both are put back afterwards
+    void render(GLStateCache &cache, float screenWidth, float screenHeight);
+    
+    // Glyph quads built and draw calls issued, reset by the caller
+    unsigned int glyphsBuilt, drawCalls;
+
+private:
+    // A piece of text and its cached quads
+    struct TextEntry
+    {
+        std::string text;
+        float x, y;
+        glm::vec3 color;
+        bool visible;
+        std::vector<TextVertex> vertices;
+    };
+    
+    // Where a glyph sits in the atlas and how it is placed relative to the pen position
+    struct Glyph
+    {
+        float offsetX, offsetY, width, height, advance;
+        float s0, t0, s1, t1;
+    };
+    
+    // Rebuilds the quads of one piece of text
+    void buildText(TextEntry &entry);
+    
+    // Makes sure the index buffer covers the given number of glyphs
+    void reserveGlyphs(size_t glyphs);
+    
+    std::vector<TextEntry> mTexts;
+    
+    // Set whenever text changed and the vertex buffer has to be filled again
+    bool mDirty;
+    
+    // Metrics of every baked character, all zero until a font loads so text without one measures as empty
+    Glyph mGlyphs[TEXT_CHAR_COUNT];
+    float mAscent, mLineHeight;
+    
+    // Glyph atlas, the shared buffers and the shader that draws them
+    unsigned int mAtlas, mVAO, mVBO, mEBO;
+    std::unique_ptr<Shader> mShader;
+    
+    // Vertices of every visible piece of text for the current upload, and the glyph capacity of the buffers
+    std::vector<TextVertex> mVertices;
+    size_t mIndexedGlyphs, mUploadedGlyphs;
+};
+
+#endif /* text_hpp */